@@ -1,9 +1,57 @@
 #pragma once
 
 #include <string>
+#include <string_view>
+#include <span>
+#include <vector>
+#include <array>
+#include <map>
+#include <algorithm>
+#include <functional>
+#include <new>
+#include <bit>
+#include <concepts>
+#include <type_traits>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
 #include <iterator>
+#include <initializer_list>
 #include <ios>
+#include <utility>
+#include <optional>
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <condition_variable>
+#include <latch>
+#include <deque>
+#include <exception>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
 
 namespace helper {
 
@@ -23,4 +71,2777 @@ inline std::ifstream read_file_as_stream(std::string const& file_path) {
   return ifs;
 }
 
+// A read-only, zero-copy view of a whole file backed by `mmap`.
+//
+// The mapping lives as long as the `mapped_file` object, so any `string_view`
+// or span obtained from it must not outlive it. An empty file yields an empty
+// view without creating a mapping.
+class mapped_file {
+public:
+  enum class access_hint { normal, sequential, random };
+
+  explicit mapped_file(std::string const& file_path, access_hint hint = access_hint::normal) {
+    int fd = ::open(file_path.c_str(), O_RDONLY);
+    if (fd == -1) {
+      throw std::ios_base::failure("Failed to open file: " + file_path);
+    }
+
+    struct stat st{};
+    if (::fstat(fd, &st) == -1) {
+      ::close(fd);
+      throw std::ios_base::failure("Failed to stat file: " + file_path);
+    }
+
+    size_ = static_cast<std::size_t>(st.st_size);
+    if (size_ > 0) {
+      void* addr = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (addr == MAP_FAILED) {
+        ::close(fd);
+        throw std::ios_base::failure("Failed to map file: " + file_path);
+      }
+      data_ = static_cast<char const*>(addr);
+
+      // Advice is only a hint, so a failure here is deliberately ignored.
+      if (hint == access_hint::sequential) {
+        ::madvise(addr, size_, MADV_SEQUENTIAL);
+      } else if (hint == access_hint::random) {
+        ::madvise(addr, size_, MADV_RANDOM);
+      }
+    }
+
+    // The mapping stays valid after the descriptor is closed.
+    ::close(fd);
+  }
+
+  mapped_file(mapped_file const&) = delete;
+  mapped_file& operator=(mapped_file const&) = delete;
+
+  mapped_file(mapped_file&& other) noexcept
+    : data_{std::exchange(other.data_, nullptr)}, size_{std::exchange(other.size_, 0)} {}
+
+  mapped_file& operator=(mapped_file&& other) noexcept {
+    if (this != &other) {
+      unmap();
+      data_ = std::exchange(other.data_, nullptr);
+      size_ = std::exchange(other.size_, 0);
+    }
+    return *this;
+  }
+
+  ~mapped_file() { unmap(); }
+
+  char const* data() const noexcept { return data_; }
+  std::size_t size() const noexcept { return size_; }
+  bool empty() const noexcept { return size_ == 0; }
+
+  std::string_view view() const noexcept { return {data_, size_}; }
+  std::span<std::byte const> bytes() const noexcept {
+    return {reinterpret_cast<std::byte const*>(data_), size_};
+  }
+
+  operator std::string_view() const noexcept { return view(); }
+
+private:
+  void unmap() noexcept {
+    if (data_ != nullptr) {
+      ::munmap(const_cast<char*>(data_), size_);
+      data_ = nullptr;
+      size_ = 0;
+    }
+  }
+
+  char const* data_ = nullptr;
+  std::size_t size_ = 0;
+};
+
+// Splits off the first line of `text` (without its trailing '\n') and advances
+// `text` past it.
+inline std::string_view pop_line(std::string_view& text) {
+  std::size_t eol = text.find('\n');
+  std::string_view line = text.substr(0, eol);
+  text.remove_prefix(eol == std::string_view::npos ? text.size() : eol + 1);
+  return line;
+}
+
+namespace simd {
+
+// Number of bytes classified per call by the mask functions below. Bit `i` of
+// a returned mask corresponds to `p[i]`, and `p` must have at least
+// `block_size` readable bytes.
+inline constexpr std::size_t block_size = 32;
+
+#if defined(__AVX2__)
+
+inline uint32_t digit_mask(char const* p) {
+  __m256i v = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(p));
+  // Shift '0'..'9' down to the bottom of the signed range, so a single signed
+  // compare tells digits apart from everything else.
+  __m256i t = _mm256_sub_epi8(v, _mm256_set1_epi8(static_cast<char>('0' + 128)));
+  __m256i m = _mm256_cmpgt_epi8(_mm256_set1_epi8(-128 + 10), t);
+  return static_cast<uint32_t>(_mm256_movemask_epi8(m));
+}
+
+inline uint32_t byte_mask(char const* p, char c) {
+  __m256i v = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(p));
+  return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(c))));
+}
+
+#elif defined(__SSE2__)
+
+inline uint32_t digit_mask16(char const* p) {
+  __m128i v = _mm_loadu_si128(reinterpret_cast<__m128i const*>(p));
+  __m128i t = _mm_sub_epi8(v, _mm_set1_epi8(static_cast<char>('0' + 128)));
+  __m128i m = _mm_cmpgt_epi8(_mm_set1_epi8(-128 + 10), t);
+  return static_cast<uint32_t>(_mm_movemask_epi8(m));
+}
+
+inline uint32_t byte_mask16(char const* p, char c) {
+  __m128i v = _mm_loadu_si128(reinterpret_cast<__m128i const*>(p));
+  return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8(c))));
+}
+
+inline uint32_t digit_mask(char const* p) {
+  return digit_mask16(p) | (digit_mask16(p + 16) << 16);
+}
+
+inline uint32_t byte_mask(char const* p, char c) {
+  return byte_mask16(p, c) | (byte_mask16(p + 16, c) << 16);
+}
+
+#elif defined(__ARM_NEON)
+
+// NEON has no movemask, so weight each lane by its bit and sum each half.
+inline uint32_t movemask16(uint8x16_t m) {
+  uint8x16_t const weights{1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128};
+  uint8x16_t bits = vandq_u8(m, weights);
+  return vaddv_u8(vget_low_u8(bits)) | (static_cast<uint32_t>(vaddv_u8(vget_high_u8(bits))) << 8);
+}
+
+inline uint32_t digit_mask(char const* p) {
+  auto half = [](char const* q) {
+    uint8x16_t v = vld1q_u8(reinterpret_cast<uint8_t const*>(q));
+    return movemask16(vcltq_u8(vsubq_u8(v, vdupq_n_u8('0')), vdupq_n_u8(10)));
+  };
+  return half(p) | (half(p + 16) << 16);
+}
+
+inline uint32_t byte_mask(char const* p, char c) {
+  auto half = [c](char const* q) {
+    uint8x16_t v = vld1q_u8(reinterpret_cast<uint8_t const*>(q));
+    return movemask16(vceqq_u8(v, vdupq_n_u8(static_cast<uint8_t>(c))));
+  };
+  return half(p) | (half(p + 16) << 16);
+}
+
+#else
+
+inline uint32_t digit_mask(char const* p) {
+  uint32_t mask = 0;
+  for (std::size_t i = 0; i < block_size; ++i) {
+    mask |= static_cast<uint32_t>(static_cast<unsigned char>(p[i] - '0') < 10) << i;
+  }
+  return mask;
+}
+
+inline uint32_t byte_mask(char const* p, char c) {
+  uint32_t mask = 0;
+  for (std::size_t i = 0; i < block_size; ++i) {
+    mask |= static_cast<uint32_t>(p[i] == c) << i;
+  }
+  return mask;
+}
+
+#endif
+
+// Sum of `|a[i] - b[i]|` for `i` in `[0, n)`. Each difference must fit in
+// `int32_t`, which holds whenever both values are non-negative.
+inline int64_t abs_diff_sum(int32_t const* a, int32_t const* b, std::size_t n) {
+  int64_t sum = 0;
+  std::size_t i = 0;
+#if defined(__AVX2__)
+  // Differences are widened to 64-bit lanes before they are added up, so
+  // the running sums can't overflow.
+  __m256i acc = _mm256_setzero_si256();
+  for (; i + 8 <= n; i += 8) {
+    __m256i d = _mm256_abs_epi32(_mm256_sub_epi32(_mm256_loadu_si256(reinterpret_cast<__m256i const*>(a + i)),
+                                                  _mm256_loadu_si256(reinterpret_cast<__m256i const*>(b + i))));
+    acc = _mm256_add_epi64(acc, _mm256_cvtepu32_epi64(_mm256_castsi256_si128(d)));
+    acc = _mm256_add_epi64(acc, _mm256_cvtepu32_epi64(_mm256_extracti128_si256(d, 1)));
+  }
+  alignas(32) int64_t lanes[4];
+  _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), acc);
+  sum = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+#elif defined(__SSE2__)
+  // SSE2 has no 32-bit abs, so flip negative lanes by hand: (d ^ s) - s.
+  __m128i const zero = _mm_setzero_si128();
+  __m128i acc = zero;
+  for (; i + 4 <= n; i += 4) {
+    __m128i d = _mm_sub_epi32(_mm_loadu_si128(reinterpret_cast<__m128i const*>(a + i)),
+                              _mm_loadu_si128(reinterpret_cast<__m128i const*>(b + i)));
+    __m128i s = _mm_srai_epi32(d, 31);
+    d = _mm_sub_epi32(_mm_xor_si128(d, s), s);
+    acc = _mm_add_epi64(acc, _mm_unpacklo_epi32(d, zero));
+    acc = _mm_add_epi64(acc, _mm_unpackhi_epi32(d, zero));
+  }
+  alignas(16) int64_t lanes[2];
+  _mm_store_si128(reinterpret_cast<__m128i*>(lanes), acc);
+  sum = lanes[0] + lanes[1];
+#elif defined(__ARM_NEON)
+  uint64x2_t acc = vdupq_n_u64(0);
+  for (; i + 4 <= n; i += 4) {
+    acc = vpadalq_u32(acc, vreinterpretq_u32_s32(vabdq_s32(vld1q_s32(a + i), vld1q_s32(b + i))));
+  }
+  sum = static_cast<int64_t>(vaddvq_u64(acc));
+#endif
+  for (; i < n; ++i) { sum += std::abs(int64_t{a[i]} - b[i]); }
+  return sum;
+}
+
+} // namespace simd
+
+// Pulls non-negative (or, for signed types, optionally `-`-prefixed) integers
+// out of a text buffer without allocating.
+//
+// Everything that is not a digit is treated as a separator; `delimiter()` and
+// `newline_before()` let the caller recover line and field structure (e.g.
+// `a|b`, `a: b c`, one report per line) without splitting the text first.
+class number_scanner {
+public:
+  explicit number_scanner(std::string_view text) noexcept
+    : begin_{text.data()}, cur_{text.data()}, end_{text.data() + text.size()} {}
+
+  // Parses the next number into `value`. Returns false once the buffer holds
+  // no more digits.
+  template<std::integral T>
+  bool next(T& value) noexcept {
+    char const* p = skip_separators(cur_);
+    if (p == end_) {
+      cur_ = p;
+      return false;
+    }
+
+    bool const negative = std::is_signed_v<T> && p != begin_ && p[-1] == '-';
+
+    std::size_t run = 0;
+    while (end_ - (p + run) >= static_cast<std::ptrdiff_t>(simd::block_size)) {
+      uint32_t non_digits = ~simd::digit_mask(p + run);
+      run += non_digits == 0 ? simd::block_size : std::countr_zero(non_digits);
+      if (non_digits != 0) { break; }
+    }
+    while (p + run < end_ && is_digit(p[run])) { ++run; }
+
+    std::make_unsigned_t<T> acc = 0;
+    for (std::size_t i = 0; i < run; ++i) {
+      acc = acc * 10 + static_cast<unsigned char>(p[i] - '0');
+    }
+
+    value = negative ? static_cast<T>(0 - acc) : static_cast<T>(acc);
+    cur_ = p + run;
+    return true;
+  }
+
+  // The byte right after the last parsed number, or '\0' at the end of the
+  // buffer.
+  char delimiter() const noexcept { return cur_ != end_ ? *cur_ : '\0'; }
+
+  // Whether a line break was skipped on the way to the last parsed number.
+  bool newline_before() const noexcept { return newline_before_; }
+
+  std::string_view rest() const noexcept { return {cur_, static_cast<std::size_t>(end_ - cur_)}; }
+
+private:
+  static bool is_digit(char c) noexcept {
+    return static_cast<unsigned char>(c - '0') < 10;
+  }
+
+  char const* skip_separators(char const* p) noexcept {
+    newline_before_ = false;
+    while (end_ - p >= static_cast<std::ptrdiff_t>(simd::block_size)) {
+      uint32_t digits = simd::digit_mask(p);
+      uint32_t newlines = simd::byte_mask(p, '\n');
+      if (digits == 0) {
+        newline_before_ |= newlines != 0;
+        p += simd::block_size;
+        continue;
+      }
+
+      int offset = std::countr_zero(digits);
+      newline_before_ |= (newlines & ((uint32_t{1} << offset) - 1)) != 0;
+      return p + offset;
+    }
+
+    while (p != end_ && !is_digit(*p)) {
+      newline_before_ |= *p == '\n';
+      ++p;
+    }
+    return p;
+  }
+
+  char const* begin_;
+  char const* cur_;
+  char const* end_;
+  bool newline_before_ = false;
+};
+
+inline constexpr std::size_t cache_line_size = 64;
+
+template<typename T, std::size_t Alignment>
+struct aligned_allocator {
+  using value_type = T;
+
+  template<typename U>
+  struct rebind { using other = aligned_allocator<U, Alignment>; };
+
+  aligned_allocator() noexcept = default;
+  template<typename U>
+  aligned_allocator(aligned_allocator<U, Alignment> const&) noexcept {}
+
+  T* allocate(std::size_t n) {
+    return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t{Alignment}));
+  }
+
+  void deallocate(T* p, std::size_t) noexcept {
+    ::operator delete(p, std::align_val_t{Alignment});
+  }
+
+  template<typename U>
+  bool operator==(aligned_allocator<U, Alignment> const&) const noexcept { return true; }
+};
+
+// A 2D map stored in one contiguous row-major buffer.
+//
+// The map is surrounded by `border` rows/columns filled with `sentinel`, so
+// walking up to `border` steps from any cell in any direction stays inside the
+// buffer and lands on a recognizable value instead of needing a bounds check.
+// Cells are addressed either by (row, col) in map coordinates or by a linear
+// index into the buffer; moving by (drow, dcol) is adding `offset(drow, dcol)`
+// to an index. Each buffer row is padded to a whole number of cache lines.
+//
+// Note: `Grid<bool>` would be backed by `std::vector<bool>`, so use `char`.
+template<typename T>
+class Grid {
+public:
+  Grid() = default;
+
+  Grid(int rows, int cols, T fill = T{}, int border = 0, T sentinel = T{})
+    : rows_{rows}, cols_{cols}, border_{border}, stride_{padded_stride(cols + 2 * border)},
+      cells_(static_cast<std::size_t>(rows + 2 * border) * stride_, sentinel) {
+    for (int row = 0; row < rows_; ++row) {
+      std::fill_n(cells_.begin() + index(row, 0), cols_, fill);
+    }
+  }
+
+  // Builds a grid from newline-separated text, stopping at the first empty
+  // line. Each byte is turned into a cell by `to_cell`.
+  template<typename CellFn = std::identity>
+  static Grid parse(std::string_view text, int border = 0, T sentinel = T{}, CellFn to_cell = {}) {
+    std::vector<std::string_view> lines{};
+    while (!text.empty()) {
+      std::string_view line = pop_line(text);
+      if (line.empty()) { break; }
+      lines.push_back(line);
+    }
+
+    Grid grid(lines.size(), lines.empty() ? 0 : lines[0].size(), sentinel, border, sentinel);
+    for (int row = 0; row < grid.rows_; ++row) {
+      std::string_view line = lines[row].substr(0, grid.cols_);
+      std::transform(line.cbegin(), line.cend(), grid.cells_.begin() + grid.index(row, 0), to_cell);
+    }
+
+    return grid;
+  }
+
+  int rows() const noexcept { return rows_; }
+  int cols() const noexcept { return cols_; }
+  int border() const noexcept { return border_; }
+  int stride() const noexcept { return stride_; }
+  std::size_t buffer_size() const noexcept { return cells_.size(); }
+
+  int index(int row, int col) const noexcept { return (row + border_) * stride_ + col + border_; }
+  int row_of(int idx) const noexcept { return idx / stride_ - border_; }
+  int col_of(int idx) const noexcept { return idx % stride_ - border_; }
+  int offset(int drow, int dcol) const noexcept { return drow * stride_ + dcol; }
+
+  bool in_bounds(int row, int col) const noexcept {
+    return row >= 0 && row < rows_ && col >= 0 && col < cols_;
+  }
+
+  // Offsets to the up, right, down and left neighbors, in that order.
+  std::array<int, 4> neighbor_offsets4() const noexcept {
+    return {offset(-1, 0), offset(0, 1), offset(1, 0), offset(0, -1)};
+  }
+
+  // Offsets to the N, NE, E, SE, S, SW, W and NW neighbors, in that order.
+  std::array<int, 8> neighbor_offsets8() const noexcept {
+    return {offset(-1, 0), offset(-1, 1), offset(0, 1), offset(1, 1),
+            offset(1, 0), offset(1, -1), offset(0, -1), offset(-1, -1)};
+  }
+
+  T& operator[](int idx) noexcept { return cells_[idx]; }
+  T const& operator[](int idx) const noexcept { return cells_[idx]; }
+
+  T& operator()(int row, int col) noexcept { return cells_[index(row, col)]; }
+  T const& operator()(int row, int col) const noexcept { return cells_[index(row, col)]; }
+
+  T* data() noexcept { return cells_.data(); }
+  T const* data() const noexcept { return cells_.data(); }
+
+  std::span<T> row(int row) noexcept { return {cells_.data() + index(row, 0), static_cast<std::size_t>(cols_)}; }
+  std::span<T const> row(int row) const noexcept { return {cells_.data() + index(row, 0), static_cast<std::size_t>(cols_)}; }
+
+  // Returns the index of the first map cell equal to `value`, or -1.
+  int find(T const& value) const noexcept {
+    for (int row = 0; row < rows_; ++row) {
+      auto cells = this->row(row);
+      if (auto it = std::find(cells.begin(), cells.end(), value); it != cells.end()) {
+        return index(row, static_cast<int>(it - cells.begin()));
+      }
+    }
+    return -1;
+  }
+
+private:
+  static int padded_stride(int width) noexcept {
+    if constexpr (cache_line_size % sizeof(T) == 0) {
+      constexpr int per_line = cache_line_size / sizeof(T);
+      return (width + per_line - 1) / per_line * per_line;
+    } else {
+      return width;
+    }
+  }
+
+  int rows_ = 0;
+  int cols_ = 0;
+  int border_ = 0;
+  int stride_ = 0;
+  std::vector<T, aligned_allocator<T, cache_line_size>> cells_{};
+};
+
+// One bit per cell of a `rows` x `cols` board, 64 columns to a word, for
+// testing a condition on a whole row of cells with a few word operations.
+//
+// `word(row, w, shift)` returns the 64 cells of `row` that start at column
+// `64 * w + shift`, with bit `i` for column `64 * w + shift + i`. The row is
+// shifted across word boundaries, so ANDing words of several rows at
+// different shifts tests cells along any direction. Each row has a zero word
+// on either side and the bits past the last column are zero, so cells off
+// the board read as unset for any `|shift| < 64`.
+class BitGrid {
+public:
+  BitGrid() = default;
+
+  BitGrid(int rows, int cols)
+    : rows_{rows}, cols_{cols}, words_{(cols + 63) / 64}, stride_{words_ + 2},
+      bits_(static_cast<std::size_t>(rows) * stride_) {}
+
+  int rows() const noexcept { return rows_; }
+  int cols() const noexcept { return cols_; }
+  // Words per row, not counting the zero padding.
+  int words() const noexcept { return words_; }
+
+  void set(int row, int col) noexcept { at(row, col / 64) |= uint64_t{1} << (col % 64); }
+  bool test(int row, int col) const noexcept { return (at(row, col / 64) >> (col % 64)) & 1; }
+
+  // Sets word `w` of `row` at once. Bits past the last column must be zero.
+  void set_word(int row, int w, uint64_t bits) noexcept { at(row, w) = bits; }
+
+  uint64_t word(int row, int w, int shift = 0) const noexcept {
+    uint64_t const* p = &at(row, w);
+    if (shift > 0) {
+      return (p[0] >> shift) | (p[1] << (64 - shift));
+    }
+    if (shift < 0) {
+      return (p[0] << -shift) | (p[-1] >> (64 + shift));
+    }
+    return p[0];
+  }
+
+private:
+  uint64_t& at(int row, int w) noexcept { return bits_[static_cast<std::size_t>(row) * stride_ + 1 + w]; }
+  uint64_t const& at(int row, int w) const noexcept {
+    return bits_[static_cast<std::size_t>(row) * stride_ + 1 + w];
+  }
+
+  int rows_ = 0;
+  int cols_ = 0;
+  int words_ = 0;
+  int stride_ = 0;
+  std::vector<uint64_t> bits_{};
+};
+
+// Streams a file (or stdin, for path "-") through a fixed-size buffer, so
+// inputs larger than memory or piped in from another job can be processed
+// in a single pass.
+//
+// The consumer sees `(std::string_view data, bool is_last)` and returns how
+// many leading bytes of `data` it has fully dealt with. Whatever it leaves
+// (a partial line, or a token that may continue in the next block) is moved
+// to the front of the buffer and handed over again, followed by fresh bytes.
+// On the last call everything should be consumed. If the consumer can't make
+// progress on a full buffer (a single record longer than the buffer), the
+// buffer doubles.
+class chunk_reader {
+public:
+  static constexpr std::size_t default_chunk_size = std::size_t{1} << 20;
+
+  explicit chunk_reader(std::string const& file_path, std::size_t chunk_size = default_chunk_size)
+    : buffer_(std::max<std::size_t>(chunk_size, 1)) {
+    if (file_path == "-") {
+      fd_ = STDIN_FILENO;
+      return;
+    }
+
+    fd_ = ::open(file_path.c_str(), O_RDONLY);
+    if (fd_ == -1) {
+      throw std::ios_base::failure("Failed to open file: " + file_path);
+    }
+    owns_fd_ = true;
+  }
+
+  chunk_reader(chunk_reader const&) = delete;
+  chunk_reader& operator=(chunk_reader const&) = delete;
+
+  ~chunk_reader() {
+    if (owns_fd_) { ::close(fd_); }
+  }
+
+  template<typename Consume>
+  void read(Consume&& consume) {
+    std::size_t carried = 0;
+    bool eof = false;
+    while (!eof) {
+      if (carried == buffer_.size()) {
+        buffer_.resize(buffer_.size() * 2);
+      }
+
+      std::size_t filled = carried;
+      while (filled < buffer_.size()) {
+        ssize_t n = ::read(fd_, buffer_.data() + filled, buffer_.size() - filled);
+        if (n < 0) {
+          throw std::ios_base::failure("Failed to read input");
+        }
+        if (n == 0) {
+          eof = true;
+          break;
+        }
+        filled += static_cast<std::size_t>(n);
+      }
+
+      std::size_t consumed = std::min(consume(std::string_view{buffer_.data(), filled}, eof), filled);
+      carried = filled - consumed;
+      std::memmove(buffer_.data(), buffer_.data() + consumed, carried);
+    }
+  }
+
+  // Hands every line (without its '\n') to `on_line`.
+  template<typename OnLine>
+  void for_each_line(OnLine&& on_line) {
+    read([&](std::string_view data, bool is_last) {
+      std::size_t consumed = 0;
+      for (std::size_t eol; (eol = data.find('\n', consumed)) != std::string_view::npos; consumed = eol + 1) {
+        on_line(data.substr(consumed, eol - consumed));
+      }
+      if (is_last && consumed < data.size()) {
+        on_line(data.substr(consumed));
+        consumed = data.size();
+      }
+      return consumed;
+    });
+  }
+
+private:
+  std::vector<char> buffer_;
+  int fd_ = -1;
+  bool owns_fd_ = false;
+};
+
+// A list of variable-length rows (e.g. one report per input line) kept in
+// one contiguous value buffer plus an offsets array, instead of one heap
+// block per row. Row `i` spans `[offsets[i], offsets[i + 1])` and is handed
+// out as a `std::span`.
+//
+// Rows are built in order: `start_row()` opens a new (empty) last row and
+// `push_back` appends to it, which is exactly what a line-by-line parser
+// does.
+template<typename T>
+class Jagged {
+public:
+  class iterator {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = std::span<T const>;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = value_type;
+
+    iterator() = default;
+    iterator(Jagged const* owner, std::size_t row) : owner_{owner}, row_{row} {}
+
+    value_type operator*() const { return (*owner_)[row_]; }
+    iterator& operator++() { ++row_; return *this; }
+    iterator operator++(int) { auto old = *this; ++row_; return old; }
+    bool operator==(iterator const& other) const = default;
+
+  private:
+    Jagged const* owner_ = nullptr;
+    std::size_t row_ = 0;
+  };
+
+  Jagged() = default;
+
+  void reserve(std::size_t rows, std::size_t values) {
+    offsets_.reserve(rows + 1);
+    values_.reserve(values);
+  }
+
+  void start_row() { offsets_.push_back(values_.size()); }
+
+  // Appends to the last row; `start_row()` must have been called at least once.
+  void push_back(T value) {
+    values_.push_back(value);
+    offsets_.back() = values_.size();
+  }
+
+  template<typename Range>
+  void add_row(Range const& row) {
+    start_row();
+    values_.insert(values_.end(), std::begin(row), std::end(row));
+    offsets_.back() = values_.size();
+  }
+
+  std::size_t size() const noexcept { return offsets_.size() - 1; }
+  bool empty() const noexcept { return size() == 0; }
+  std::size_t total_size() const noexcept { return values_.size(); }
+
+  std::span<T> operator[](std::size_t row) noexcept {
+    return {values_.data() + offsets_[row], offsets_[row + 1] - offsets_[row]};
+  }
+  std::span<T const> operator[](std::size_t row) const noexcept {
+    return {values_.data() + offsets_[row], offsets_[row + 1] - offsets_[row]};
+  }
+
+  std::span<T> back() noexcept { return (*this)[size() - 1]; }
+  std::span<T const> back() const noexcept { return (*this)[size() - 1]; }
+
+  std::span<T const> values() const noexcept { return values_; }
+
+  iterator begin() const noexcept { return {this, 0}; }
+  iterator end() const noexcept { return {this, size()}; }
+  iterator cbegin() const noexcept { return begin(); }
+  iterator cend() const noexcept { return end(); }
+
+private:
+  std::vector<T> values_{};
+  // Row ends, behind a leading 0, so there is always one more than rows.
+  std::vector<std::size_t> offsets_{0};
+};
+
+// Maps names (wire names, node names, ...) to dense `uint32_t` ids in order
+// of first appearance, so a solver can index plain vectors by id instead of
+// hashing and comparing strings in its hot loops. `name(id)` is the reverse
+// lookup, meant for printing answers.
+//
+// The characters of all names live in one buffer, laid out like `Jagged`, and
+// the lookup table is an open-addressing array of ids. Nothing points into
+// the buffer, so growing it never invalidates the table.
+class Interner {
+public:
+  using id_type = uint32_t;
+
+  Interner() = default;
+
+  void reserve(std::size_t names, std::size_t chars) {
+    ends_.reserve(names + 1);
+    hashes_.reserve(names);
+    chars_.reserve(chars);
+    if (names * 2 > slots_.size()) { rehash(std::bit_ceil(names * 2)); }
+  }
+
+  // Returns the id of `name`, assigning the next free one if it is new.
+  id_type intern(std::string_view name) {
+    if ((size() + 1) * 2 > slots_.size()) {
+      rehash(std::max<std::size_t>(16, slots_.size() * 2));
+    }
+
+    std::size_t const hash = std::hash<std::string_view>{}(name);
+    std::size_t slot = probe(name, hash);
+    if (slots_[slot] != empty_slot) { return slots_[slot]; }
+
+    auto const id = static_cast<id_type>(size());
+    chars_.append(name);
+    ends_.push_back(chars_.size());
+    hashes_.push_back(hash);
+    slots_[slot] = id;
+    return id;
+  }
+
+  std::optional<id_type> find(std::string_view name) const {
+    if (slots_.empty()) { return std::nullopt; }
+    id_type const id = slots_[probe(name, std::hash<std::string_view>{}(name))];
+    return id == empty_slot ? std::nullopt : std::optional<id_type>{id};
+  }
+
+  bool contains(std::string_view name) const { return find(name).has_value(); }
+
+  std::string_view name(id_type id) const {
+    return std::string_view{chars_}.substr(ends_[id], ends_[id + 1] - ends_[id]);
+  }
+
+  std::size_t size() const noexcept { return ends_.size() - 1; }
+  bool empty() const noexcept { return size() == 0; }
+
+private:
+  static constexpr id_type empty_slot = UINT32_MAX;
+
+  // The slot holding `name`, or the empty slot where it would go.
+  std::size_t probe(std::string_view name, std::size_t hash) const {
+    std::size_t const mask = slots_.size() - 1;
+    for (std::size_t slot = hash & mask;; slot = (slot + 1) & mask) {
+      id_type const id = slots_[slot];
+      if (id == empty_slot || (hashes_[id] == hash && this->name(id) == name)) { return slot; }
+    }
+  }
+
+  void rehash(std::size_t capacity) {
+    slots_.assign(capacity, empty_slot);
+    std::size_t const mask = capacity - 1;
+    for (id_type id = 0; id < size(); ++id) {
+      std::size_t slot = hashes_[id] & mask;
+      while (slots_[slot] != empty_slot) { slot = (slot + 1) & mask; }
+      slots_[slot] = id;
+    }
+  }
+
+  std::string chars_{};
+  // Name ends, behind a leading 0, as in `Jagged`.
+  std::vector<std::size_t> ends_{0};
+  std::vector<std::size_t> hashes_{};
+  // Power-of-two sized and at most half full, so probe chains stay short.
+  std::vector<id_type> slots_{};
+};
+
+// Fixed regular expressions compiled into DFAs at compile time:
+//
+//   using gate_line = helper::pattern<R"((\w+)\s+(AND|OR|XOR)\s+(\w+)\s*->\s*(\w+))">;
+//   if (auto m = gate_line::match(line)) { use((*m)[1], (*m)[2], ...); }
+//
+// `match` must cover the whole text, like `std::regex_match`. `search` finds
+// the leftmost match at or after `pos`, taking the longest one from there.
+// Both return the whole match and every group as `string_view`s into the
+// text, with an empty view for a group that took no part. Nothing is
+// allocated while matching.
+//
+// The syntax covers what fixed-format puzzle lines need: literals, `.`,
+// `\d \w \s` (and `\D \W \S`), `\n \t`, escaped punctuation (any other
+// escaped letter or digit is an error), `[...]` classes with ranges and `^`,
+// `(...)` groups, `(?:...)`, `|`, and the quantifiers `* + ? {m} {m,} {m,n}`.
+//
+// The pattern becomes a Thompson NFA. Subset construction turns that into a
+// DFA over byte classes. Group boundaries are tags on NFA edges, and each DFA
+// transition records the tags its threads crossed since the last byte. That
+// takes a single pass with no backtracking. It only works if every thread
+// that survives a transition agrees on where its groups start and end. A
+// pattern where they could disagree fails to compile as "ambiguous
+// captures".
+namespace regex {
+
+template<std::size_t N>
+struct fixed_string {
+  char chars[N]{};
+
+  constexpr fixed_string(char const (&s)[N]) { std::copy_n(s, N, chars); }
+  constexpr std::string_view view() const { return {chars, N - 1}; }
+};
+
+inline constexpr int max_ast_nodes = 256;
+inline constexpr int max_nfa_states = 256;
+inline constexpr int max_dfa_states = 64;
+inline constexpr int max_classes = 64;
+inline constexpr int max_groups = 8;
+inline constexpr int unbounded = -1;
+
+struct byte_set {
+  std::array<uint64_t, 4> bits{};
+
+  constexpr void add(unsigned char c) { bits[c >> 6] |= uint64_t{1} << (c & 63); }
+  constexpr void add_range(unsigned char lo, unsigned char hi) {
+    for (unsigned c = lo; c <= hi; ++c) { add(static_cast<unsigned char>(c)); }
+  }
+  constexpr void add(byte_set const& other) {
+    for (std::size_t i = 0; i < bits.size(); ++i) { bits[i] |= other.bits[i]; }
+  }
+  constexpr void invert() {
+    for (auto& word : bits) { word = ~word; }
+  }
+  constexpr bool contains(unsigned char c) const { return (bits[c >> 6] >> (c & 63)) & 1; }
+};
+
+struct ast_node {
+  enum kind_t : uint8_t { empty, set, concat, alt, repeat, group } kind = empty;
+  int lhs = -1;
+  int rhs = -1;
+  int min = 0;
+  int max = 0;
+  int group_index = 0;
+  byte_set bytes{};
+};
+
+// Recursive descent over the pattern into `nodes`, rooted at `root`.
+struct parser {
+  std::string_view src;
+  std::size_t pos = 0;
+  std::array<ast_node, max_ast_nodes> nodes{};
+  int count = 0;
+  int groups = 0;
+  int root = -1;
+
+  constexpr explicit parser(std::string_view pattern) : src{pattern} {
+    root = parse_alt();
+    if (pos != src.size()) { throw std::invalid_argument("unbalanced `)` in pattern"); }
+  }
+
+  constexpr int add(ast_node node) {
+    if (count == max_ast_nodes) { throw std::length_error("pattern too long"); }
+    nodes[count] = node;
+    return count++;
+  }
+
+  constexpr bool more() const { return pos < src.size(); }
+
+  constexpr void expect(char c) {
+    if (!more() || src[pos] != c) { throw std::invalid_argument("malformed pattern"); }
+    ++pos;
+  }
+
+  constexpr int parse_alt() {
+    int lhs = parse_concat();
+    while (more() && src[pos] == '|') {
+      ++pos;
+      int const rhs = parse_concat();
+      lhs = add({ast_node::alt, lhs, rhs});
+    }
+    return lhs;
+  }
+
+  constexpr int parse_concat() {
+    int res = add({ast_node::empty});
+    while (more() && src[pos] != '|' && src[pos] != ')') {
+      int const next = parse_repeat();
+      res = add({ast_node::concat, res, next});
+    }
+    return res;
+  }
+
+  constexpr int parse_repeat() {
+    int res = parse_atom();
+    while (more()) {
+      int min = 0;
+      int max = unbounded;
+      char const c = src[pos];
+      if (c == '*') {
+        ++pos;
+      } else if (c == '+') {
+        ++pos;
+        min = 1;
+      } else if (c == '?') {
+        ++pos;
+        max = 1;
+      } else if (c == '{') {
+        ++pos;
+        min = max = parse_int();
+        if (more() && src[pos] == ',') {
+          ++pos;
+          max = more() && src[pos] == '}' ? unbounded : parse_int();
+        }
+        expect('}');
+        if (max != unbounded && max < min) { throw std::invalid_argument("bad repeat range in pattern"); }
+      } else {
+        break;
+      }
+      res = add({ast_node::repeat, res, -1, min, max});
+    }
+    return res;
+  }
+
+  constexpr int parse_int() {
+    if (!more() || src[pos] < '0' || src[pos] > '9') { throw std::invalid_argument("expected a number in pattern"); }
+    int n = 0;
+    while (more() && src[pos] >= '0' && src[pos] <= '9') { n = n * 10 + (src[pos++] - '0'); }
+    return n;
+  }
+
+  constexpr int parse_atom() {
+    if (!more()) { throw std::invalid_argument("pattern ends early"); }
+    char const c = src[pos++];
+    ast_node node{ast_node::set};
+    switch (c) {
+      case '(': {
+        bool const capture = !src.substr(pos).starts_with("?:");
+        if (!capture) { pos += 2; }
+        int const index = capture ? ++groups : 0;
+        if (groups > max_groups) { throw std::length_error("too many groups in pattern"); }
+        int const inner = parse_alt();
+        expect(')');
+        return capture ? add({ast_node::group, inner, -1, 0, 0, index}) : inner;
+      }
+      case '[':
+        node.bytes = parse_class();
+        break;
+      case '.':
+        node.bytes.add('\n');
+        node.bytes.invert();
+        break;
+      case '\\':
+        node.bytes = parse_escape();
+        break;
+      case '*': case '+': case '?': case '{': case ')': case '|':
+        throw std::invalid_argument("unexpected metacharacter in pattern");
+      default:
+        node.bytes.add(static_cast<unsigned char>(c));
+    }
+    return add(node);
+  }
+
+  constexpr byte_set parse_escape() {
+    if (!more()) { throw std::invalid_argument("pattern ends in `\\`"); }
+    char const c = src[pos++];
+    byte_set res{};
+    switch (c) {
+      case 'd': case 'D':
+        res.add_range('0', '9');
+        break;
+      case 'w': case 'W':
+        res.add_range('0', '9');
+        res.add_range('A', 'Z');
+        res.add_range('a', 'z');
+        res.add('_');
+        break;
+      case 's': case 'S':
+        for (char ws : {' ', '\t', '\n', '\r', '\f', '\v'}) { res.add(static_cast<unsigned char>(ws)); }
+        break;
+      case 'n': res.add('\n'); break;
+      case 't': res.add('\t'); break;
+      default:
+        // Other letters and digits (`\b`, `\B`, `\1`, ...) mean something
+        // else to `std::regex`, so they are errors rather than literals.
+        if ((c >= '0' && c <= '9') || (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z')) {
+          throw std::invalid_argument("unsupported escape in pattern");
+        }
+        res.add(static_cast<unsigned char>(c));
+    }
+    if (c == 'D' || c == 'W' || c == 'S') { res.invert(); }
+    return res;
+  }
+
+  constexpr byte_set parse_class() {
+    byte_set res{};
+    bool const negate = more() && src[pos] == '^';
+    if (negate) { ++pos; }
+    for (bool first = true; first || (more() && src[pos] != ']'); first = false) {
+      if (!more()) { throw std::invalid_argument("unterminated `[` in pattern"); }
+      if (src[pos] == '\\') {
+        ++pos;
+        res.add(parse_escape());
+        continue;
+      }
+      auto const lo = static_cast<unsigned char>(src[pos++]);
+      if (pos + 1 < src.size() && src[pos] == '-' && src[pos + 1] != ']') {
+        res.add_range(lo, static_cast<unsigned char>(src[pos + 1]));
+        pos += 2;
+      } else {
+        res.add(lo);
+      }
+    }
+    expect(']');
+    if (negate) { res.invert(); }
+    return res;
+  }
+};
+
+struct nfa_state {
+  enum kind_t : uint8_t { consume, split, tag, accept } kind = accept;
+  int out = -1;
+  int out2 = -1;
+  int tag_index = -1;
+  byte_set bytes{};
+};
+
+// Thompson construction, built back to front: `build(node, next)` returns
+// the entry of a fragment for `node` that continues into `next`.
+struct nfa {
+  std::array<nfa_state, max_nfa_states> states{};
+  int count = 0;
+  int start = -1;
+  int final = -1;
+
+  constexpr explicit nfa(parser const& p) {
+    final = add({nfa_state::accept});
+    start = build(p, p.root, final);
+  }
+
+  constexpr int add(nfa_state state) {
+    if (count == max_nfa_states) { throw std::length_error("pattern needs too many NFA states"); }
+    states[count] = state;
+    return count++;
+  }
+
+  constexpr int build(parser const& p, int index, int next) {
+    ast_node const& node = p.nodes[index];
+    switch (node.kind) {
+      case ast_node::empty:
+        return next;
+      case ast_node::set:
+        return add({nfa_state::consume, next, -1, -1, node.bytes});
+      case ast_node::concat:
+        return build(p, node.lhs, build(p, node.rhs, next));
+      case ast_node::alt: {
+        int const lhs = build(p, node.lhs, next);
+        int const rhs = build(p, node.rhs, next);
+        return add({nfa_state::split, lhs, rhs});
+      }
+      case ast_node::group: {
+        // Tag 2k - 2 opens group k and tag 2k - 1 closes it.
+        int const close = add({nfa_state::tag, next, -1, 2 * node.group_index - 1});
+        int const inner = build(p, node.lhs, close);
+        return add({nfa_state::tag, inner, -1, 2 * node.group_index - 2});
+      }
+      case ast_node::repeat: {
+        int res = next;
+        if (node.max == unbounded) {
+          int const loop = add({nfa_state::split});
+          states[loop].out = build(p, node.lhs, loop);
+          states[loop].out2 = next;
+          res = loop;
+        } else {
+          for (int i = node.min; i < node.max; ++i) {
+            int const body = build(p, node.lhs, res);
+            res = add({nfa_state::split, body, next});
+          }
+        }
+        for (int i = 0; i < node.min; ++i) { res = build(p, node.lhs, res); }
+        return res;
+      }
+    }
+    return next;
+  }
+};
+
+// What a compiled pattern runs on. State 0 is the start; `next` is -1 where
+// the match fails. `commit[s][c]` and `accept_tags[s]` are bit sets of tags
+// to set to the current position.
+struct program {
+  std::array<uint8_t, 256> classes{};
+  std::array<std::array<int16_t, max_classes>, max_dfa_states> next{};
+  std::array<std::array<uint16_t, max_classes>, max_dfa_states> commit{};
+  std::array<uint16_t, max_dfa_states> accept_tags{};
+  std::array<bool, max_dfa_states> accepting{};
+  int groups = 0;
+  int states = 0;
+};
+
+consteval program compile(std::string_view pattern) {
+  parser const p{pattern};
+  nfa const n{p};
+  program res{};
+  res.groups = p.groups;
+
+  // Byte classes: bytes that every NFA transition treats alike.
+  int class_count = 1;
+  for (int s = 0; s < n.count; ++s) {
+    if (n.states[s].kind != nfa_state::consume) { continue; }
+    std::array<std::array<int, 256>, 2> remap{};
+    for (auto& side : remap) { side.fill(-1); }
+    int refined = 0;
+    for (unsigned b = 0; b < 256; ++b) {
+      int& id = remap[n.states[s].bytes.contains(static_cast<unsigned char>(b))][res.classes[b]];
+      if (id == -1) { id = refined++; }
+      res.classes[b] = static_cast<uint8_t>(id);
+    }
+    class_count = refined;
+  }
+  if (class_count > max_classes) { throw std::length_error("pattern needs too many byte classes"); }
+  std::array<unsigned char, max_classes> representative{};
+  for (unsigned b = 256; b-- > 0;) { representative[res.classes[b]] = static_cast<unsigned char>(b); }
+
+  // A DFA state is the set of NFA states its threads are in, each with the
+  // tags crossed since the last byte. `present` marks membership.
+  constexpr uint32_t present = uint32_t{1} << 31;
+  using state_set = std::array<uint32_t, max_nfa_states>;
+  std::array<state_set, max_dfa_states> sets{};
+
+  auto closure = [&](std::array<std::pair<int, uint32_t>, max_nfa_states> seeds, int seed_count) {
+    state_set set{};
+    std::array<std::pair<int, uint32_t>, 2 * max_nfa_states> stack{};
+    int top = 0;
+    for (int i = 0; i < seed_count; ++i) { stack[top++] = seeds[i]; }
+    while (top > 0) {
+      auto const [s, tags] = stack[--top];
+      if (set[s] != 0) {
+        if (set[s] != (tags | present)) { throw std::invalid_argument("ambiguous captures in pattern"); }
+        continue;
+      }
+      set[s] = tags | present;
+      nfa_state const& state = n.states[s];
+      if (state.kind == nfa_state::split) {
+        stack[top++] = {state.out2, tags};
+        stack[top++] = {state.out, tags};
+      } else if (state.kind == nfa_state::tag) {
+        stack[top++] = {state.out, tags | (uint32_t{1} << state.tag_index)};
+      }
+    }
+    return set;
+  };
+
+  std::array<std::pair<int, uint32_t>, max_nfa_states> seeds{};
+  seeds[0] = {n.start, 0};
+  sets[0] = closure(seeds, 1);
+  res.states = 1;
+  for (int d = 0; d < res.states; ++d) {
+    if (sets[d][n.final] != 0) {
+      res.accepting[d] = true;
+      res.accept_tags[d] = static_cast<uint16_t>(sets[d][n.final] & ~present);
+    }
+
+    for (int c = 0; c < max_classes; ++c) {
+      res.next[d][c] = -1;
+      if (c >= class_count) { continue; }
+
+      int seed_count = 0;
+      uint32_t tags = 0;
+      for (int s = 0; s < n.count; ++s) {
+        nfa_state const& state = n.states[s];
+        if (sets[d][s] == 0 || state.kind != nfa_state::consume || !state.bytes.contains(representative[c])) {
+          continue;
+        }
+        uint32_t const crossed = sets[d][s] & ~present;
+        if (seed_count > 0 && crossed != tags) { throw std::invalid_argument("ambiguous captures in pattern"); }
+        tags = crossed;
+        seeds[seed_count++] = {state.out, 0};
+      }
+      if (seed_count == 0) { continue; }
+
+      state_set const target = closure(seeds, seed_count);
+      int found = 0;
+      while (found < res.states && sets[found] != target) { ++found; }
+      if (found == res.states) {
+        if (res.states == max_dfa_states) { throw std::length_error("pattern needs too many DFA states"); }
+        sets[res.states++] = target;
+      }
+      res.next[d][c] = static_cast<int16_t>(found);
+      res.commit[d][c] = static_cast<uint16_t>(tags);
+    }
+  }
+
+  return res;
+}
+
+} // namespace regex
+
+template<regex::fixed_string Pattern>
+class pattern {
+  static constexpr regex::program program_ = regex::compile(Pattern.view());
+
+public:
+  static constexpr std::size_t groups = program_.groups;
+
+  // `[0]` is the whole match and `[k]` group `k`.
+  using captures = std::array<std::string_view, groups + 1>;
+
+  static std::optional<captures> match(std::string_view text) {
+    tag_positions tags{};
+    if (run(text, 0, true, tags) == std::string_view::npos) { return std::nullopt; }
+    return make_captures(text, 0, text.size(), tags);
+  }
+
+  static std::optional<captures> search(std::string_view text, std::size_t pos = 0) {
+    tag_positions tags{};
+    for (; pos <= text.size(); ++pos) {
+      // Most bytes can't start a match; don't set up a run for them.
+      if (!program_.accepting[0] &&
+          (pos == text.size() || program_.next[0][program_.classes[static_cast<unsigned char>(text[pos])]] < 0)) {
+        continue;
+      }
+      std::size_t const end = run(text, pos, false, tags);
+      if (end != std::string_view::npos) { return make_captures(text, pos, end, tags); }
+    }
+    return std::nullopt;
+  }
+
+private:
+  using tag_positions = std::array<std::size_t, 2 * groups>;
+
+  static void set_tags(tag_positions& tags, uint16_t bits, std::size_t pos) {
+    for (; bits != 0; bits &= bits - 1) { tags[std::countr_zero(bits)] = pos; }
+  }
+
+  // End of the longest match starting at `begin` (only one that reaches the
+  // end of `text` if `whole`), or npos, with its tags in `best`.
+  static std::size_t run(std::string_view text, std::size_t begin, bool whole, tag_positions& best) {
+    tag_positions tags{};
+    tags.fill(std::string_view::npos);
+    std::size_t end = std::string_view::npos;
+    int state = 0;
+    auto accept_at = [&](std::size_t pos) {
+      if (!program_.accepting[state]) { return; }
+      best = tags;
+      set_tags(best, program_.accept_tags[state], pos);
+      end = pos;
+    };
+
+    if (!whole) { accept_at(begin); }
+    for (std::size_t i = begin; i < text.size(); ++i) {
+      uint8_t const cls = program_.classes[static_cast<unsigned char>(text[i])];
+      int const next = program_.next[state][cls];
+      if (next < 0) { return whole ? std::string_view::npos : end; }
+      set_tags(tags, program_.commit[state][cls], i);
+      state = next;
+      if (!whole) { accept_at(i + 1); }
+    }
+    if (whole) { accept_at(text.size()); }
+    return end;
+  }
+
+  static captures make_captures(std::string_view text, std::size_t begin, std::size_t end, tag_positions const& tags) {
+    captures res{};
+    res[0] = text.substr(begin, end - begin);
+    for (std::size_t g = 0; g < groups; ++g) {
+      std::size_t const open = tags[2 * g];
+      std::size_t const close = tags[2 * g + 1];
+      if (open != std::string_view::npos && close != std::string_view::npos && open <= close) {
+        res[g + 1] = text.substr(open, close - open);
+      }
+    }
+    return res;
+  }
+};
+
+// A work-stealing thread pool.
+//
+// Every worker owns a task deque: it pushes and pops at the back (LIFO, for
+// cache locality on nested work) and, when it runs dry, steals from the front
+// of another worker's deque (FIFO, taking the oldest and usually largest
+// piece). Threads outside the pool share one extra deque. A thread waiting
+// for its parallel region to finish keeps running tasks instead of blocking,
+// so regions nest freely: a day run by the driver on a worker can itself call
+// `parallel_for`.
+//
+// `parallel_for` and `parallel_reduce` cut `[begin, end)` into chunks of
+// `grain` indices (by default about 8 per thread) and return once every chunk
+// is done, rethrowing the first exception any chunk threw. Reductions combine
+// the chunk results in index order, so `reduce` need not be commutative and
+// the result doesn't depend on scheduling.
+//
+// `global()` is the pool the solvers use. Its size comes from the first call's
+// argument, else `AOC_THREADS`, else the hardware concurrency; a size of 1
+// runs everything inline on the calling thread.
+class thread_pool {
+public:
+  explicit thread_pool(unsigned threads = 0) {
+    if (threads == 0) {
+      char const* env = std::getenv("AOC_THREADS");
+      threads = env != nullptr && std::atoi(env) > 0 ? std::atoi(env) : std::thread::hardware_concurrency();
+    }
+    threads_ = std::max(threads, 1u);
+
+    // Slot 0 is shared by threads outside the pool; workers get 1..threads-1.
+    for (unsigned slot = 0; slot < threads_; ++slot) {
+      queues_.emplace_back(std::make_unique<task_queue>());
+    }
+    // Each worker records its kernel thread id before the constructor
+    // returns, so per-thread tools (see `perf_counters`) can find them all.
+    worker_ids_.resize(threads_ - 1);
+    std::latch started{threads_ - 1};
+    for (unsigned slot = 1; slot < threads_; ++slot) {
+      workers_.emplace_back([this, slot, &started] {
+#if defined(__linux__)
+        worker_ids_[slot - 1] = static_cast<long>(::syscall(SYS_gettid));
+#endif
+        started.count_down();
+        work(slot);
+      });
+    }
+    started.wait();
+  }
+
+  ~thread_pool() {
+    {
+      std::lock_guard lock{sleep_mutex_};
+      stopping_ = true;
+    }
+    wake_.notify_all();
+    workers_.clear();
+  }
+
+  thread_pool(thread_pool const&) = delete;
+  thread_pool& operator=(thread_pool const&) = delete;
+
+  static thread_pool& global(unsigned threads = 0) {
+    static thread_pool pool{threads};
+    return pool;
+  }
+
+  // The calling thread plus the workers.
+  unsigned size() const noexcept { return threads_; }
+
+  // Kernel thread ids of the workers (slots 1 and up); 0 off Linux.
+  std::vector<long> const& worker_ids() const noexcept { return worker_ids_; }
+
+  // This thread's slot in `[0, size())`, for indexing per-thread storage.
+  // Threads outside the pool all use slot 0, so `parallel_for` lets only one
+  // of them into a region at a time.
+  unsigned current_slot() const noexcept {
+    return current_pool() == this ? current_worker_slot() : 0;
+  }
+
+  template<typename Fn>
+  void parallel_for(std::size_t begin, std::size_t end, Fn&& fn, std::size_t grain = 0) {
+    if (begin >= end) { return; }
+    grain = grain != 0 ? grain : default_grain(end - begin);
+    if (threads_ == 1 || end - begin <= grain) {
+      for (std::size_t i = begin; i < end; ++i) { fn(i); }
+      return;
+    }
+
+    std::size_t const chunks = (end - begin + grain - 1) / grain;
+    run_chunks(chunks, [&](std::size_t chunk) {
+      std::size_t const chunk_end = std::min(end, begin + (chunk + 1) * grain);
+      for (std::size_t i = begin + chunk * grain; i < chunk_end; ++i) { fn(i); }
+    });
+  }
+
+  // Folds `map(i)` for every `i` in `[begin, end)` into `init` with `reduce`.
+  template<typename T, typename Map, typename Reduce>
+  T parallel_reduce(std::size_t begin, std::size_t end, T init, Map&& map, Reduce&& reduce, std::size_t grain = 0) {
+    if (begin >= end) { return init; }
+    grain = grain != 0 ? grain : default_grain(end - begin);
+    if (threads_ == 1 || end - begin <= grain) {
+      for (std::size_t i = begin; i < end; ++i) { init = reduce(std::move(init), map(i)); }
+      return init;
+    }
+
+    std::size_t const chunks = (end - begin + grain - 1) / grain;
+    std::vector<std::optional<T>> partials(chunks);
+    run_chunks(chunks, [&](std::size_t chunk) {
+      std::size_t const chunk_begin = begin + chunk * grain;
+      std::size_t const chunk_end = std::min(end, chunk_begin + grain);
+      T acc = map(chunk_begin);
+      for (std::size_t i = chunk_begin + 1; i < chunk_end; ++i) { acc = reduce(std::move(acc), map(i)); }
+      partials[chunk].emplace(std::move(acc));
+    });
+    for (auto& partial : partials) { init = reduce(std::move(init), std::move(*partial)); }
+    return init;
+  }
+
+private:
+  using task = std::function<void()>;
+
+  struct alignas(cache_line_size) task_queue {
+    std::mutex mutex;
+    std::deque<task> tasks;
+  };
+
+  static thread_pool*& current_pool() noexcept {
+    thread_local thread_pool* pool = nullptr;
+    return pool;
+  }
+
+  static unsigned& current_worker_slot() noexcept {
+    thread_local unsigned slot = 0;
+    return slot;
+  }
+
+  std::size_t default_grain(std::size_t n) const noexcept {
+    return std::max<std::size_t>(1, n / (std::size_t{threads_} * 8));
+  }
+
+  template<typename ChunkFn>
+  void run_chunks(std::size_t chunks, ChunkFn const& run_chunk) {
+    unsigned const slot = current_slot();
+    // Outside threads share slot 0; the recursive lock lets a task the outside
+    // thread picks up while waiting open a nested region.
+    std::unique_lock<std::recursive_mutex> outside_lock{outside_mutex_, std::defer_lock};
+    if (current_pool() != this) { outside_lock.lock(); }
+
+    std::atomic<std::size_t> remaining{chunks};
+    std::exception_ptr error{};
+    std::mutex error_mutex{};
+    // Counted before they are pushed, so a thief never drives it below zero.
+    queued_.fetch_add(chunks, std::memory_order_release);
+    {
+      auto& queue = *queues_[slot];
+      std::lock_guard lock{queue.mutex};
+      for (std::size_t chunk = chunks; chunk-- > 0;) {
+        queue.tasks.emplace_back([&, chunk] {
+          try {
+            run_chunk(chunk);
+          } catch (...) {
+            std::lock_guard error_lock{error_mutex};
+            if (!error) { error = std::current_exception(); }
+          }
+          remaining.fetch_sub(1, std::memory_order_acq_rel);
+        });
+      }
+    }
+    {
+      // Taking the lock orders this wake-up after any worker's last check.
+      std::lock_guard lock{sleep_mutex_};
+    }
+    wake_.notify_all();
+
+    while (remaining.load(std::memory_order_acquire) != 0) {
+      if (!run_one(slot)) { std::this_thread::yield(); }
+    }
+    if (error) { std::rethrow_exception(error); }
+  }
+
+  // Runs one task from `slot`'s own deque, or one stolen from another, if any.
+  bool run_one(unsigned slot) {
+    task t{};
+    if (pop_back(*queues_[slot], t)) {
+      t();
+      return true;
+    }
+    for (unsigned i = 1; i < threads_; ++i) {
+      if (pop_front(*queues_[(slot + i) % threads_], t)) {
+        t();
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool pop_back(task_queue& queue, task& t) {
+    std::lock_guard lock{queue.mutex};
+    if (queue.tasks.empty()) { return false; }
+    t = std::move(queue.tasks.back());
+    queue.tasks.pop_back();
+    queued_.fetch_sub(1, std::memory_order_relaxed);
+    return true;
+  }
+
+  bool pop_front(task_queue& queue, task& t) {
+    std::lock_guard lock{queue.mutex};
+    if (queue.tasks.empty()) { return false; }
+    t = std::move(queue.tasks.front());
+    queue.tasks.pop_front();
+    queued_.fetch_sub(1, std::memory_order_relaxed);
+    return true;
+  }
+
+  void work(unsigned slot) {
+    current_pool() = this;
+    current_worker_slot() = slot;
+    while (true) {
+      if (run_one(slot)) { continue; }
+
+      std::unique_lock lock{sleep_mutex_};
+      wake_.wait(lock, [this] { return stopping_ || queued_.load(std::memory_order_acquire) > 0; });
+      if (stopping_) { return; }
+    }
+  }
+
+  unsigned threads_ = 1;
+  std::vector<long> worker_ids_{};
+  std::vector<std::unique_ptr<task_queue>> queues_{};
+  // Tasks sitting in any deque; idle workers sleep while it is zero.
+  std::atomic<std::size_t> queued_{0};
+  std::mutex sleep_mutex_{};
+  std::condition_variable wake_{};
+  bool stopping_ = false;
+  std::recursive_mutex outside_mutex_{};
+  // Last, so the workers are joined before anything they use is destroyed.
+  std::vector<std::jthread> workers_{};
+};
+
+// One `T` per thread of a pool, each on its own cache lines, for scratch
+// buffers and partial results that parallel tasks reuse without locking:
+//
+//   helper::per_thread<std::vector<int>> scratch{pool};
+//   pool.parallel_for(0, n, [&](std::size_t i) { auto& buf = scratch.local(); ... });
+template<typename T>
+class per_thread {
+public:
+  explicit per_thread(thread_pool& pool = thread_pool::global())
+    : pool_{pool}, size_{pool.size()}, slots_{std::make_unique<slot[]>(size_)} {}
+
+  per_thread(thread_pool& pool, T const& init) : per_thread(pool) {
+    for_each([&init](T& value) { value = init; });
+  }
+
+  T& local() noexcept { return slots_[pool_.current_slot()].value; }
+
+  template<typename Fn>
+  void for_each(Fn&& fn) {
+    for (std::size_t i = 0; i < size_; ++i) { fn(slots_[i].value); }
+  }
+
+private:
+  struct alignas(cache_line_size) slot {
+    T value{};
+  };
+
+  thread_pool& pool_;
+  std::size_t size_;
+  std::unique_ptr<slot[]> slots_;
+};
+
+// Scans the rows `[0, rows)` of a board in horizontal bands, one pool task
+// each, and folds the band results in row order with `reduce`.
+//
+// `band(first, begin, end)` owns rows `[begin, end)`: it must count only
+// what it finds there, but may need to start reading at `first`, up to
+// `halo` rows earlier, to rebuild state carried down from the rows above
+// (e.g. a match of length `halo + 1` that ends in the band). Every row is
+// owned by exactly one band, so each find is counted once. Bands are kept
+// at least `8 * halo` rows tall so the re-read halo stays a small overhead.
+template<typename T, typename Band, typename Reduce>
+T reduce_row_bands(int rows, int halo, T init, Band&& band, Reduce&& reduce,
+                   thread_pool& pool = thread_pool::global()) {
+  if (rows <= 0) { return init; }
+  int const min_band_rows = std::max(16, 8 * halo);
+  int const bands = std::clamp(rows / min_band_rows, 1, static_cast<int>(pool.size()) * 4);
+  int const band_rows = (rows + bands - 1) / bands;
+  return pool.parallel_reduce(0, bands, std::move(init), [&](std::size_t i) {
+    int const begin = std::min(rows, static_cast<int>(i) * band_rows);
+    int const end = std::min(rows, begin + band_rows);
+    return band(std::max(0, begin - halo), begin, end);
+  }, reduce, 1);
+}
+
+// Finds every word of a dictionary on a character board, along all 8
+// directions, in one pass over the board however many words there are.
+//
+// The words and their reverses go into one Aho-Corasick automaton, kept as a
+// full transition table over the bytes the words use (all other bytes share
+// one symbol that leads back to the root). The board is read row by row, and
+// every row, column, diagonal and anti-diagonal carries its own automaton
+// state from cell to cell, so each line is streamed through the automaton
+// once, forwards; a match of a reversed word is the word read backwards
+// along that line.
+//
+// An occurrence is a start cell plus a direction, so a palindrome is found
+// once each way and a one-letter word once per direction.
+class word_search {
+public:
+  // `words[word]` starts at (`row`, `col`) and each next letter is one step
+  // of (`drow`, `dcol`) further.
+  struct match {
+    std::size_t word;
+    int row;
+    int col;
+    int drow;
+    int dcol;
+  };
+
+  explicit word_search(std::span<std::string_view const> words) {
+    for (std::string_view word : words) {
+      for (char ch : word) {
+        auto& symbol = symbols_[static_cast<unsigned char>(ch)];
+        if (symbol == 0) { symbol = width_++; }
+      }
+    }
+
+    std::vector<std::vector<entry>> ends(1);
+    next_.assign(width_, -1);
+    auto insert = [&](auto first, auto last, entry e) {
+      int32_t state = 0;
+      for (; first != last; ++first) {
+        std::size_t const slot = transition(state, symbols_[static_cast<unsigned char>(*first)]);
+        if (next_[slot] < 0) {
+          next_[slot] = static_cast<int32_t>(ends.size());
+          next_.resize(next_.size() + width_, -1);
+          ends.emplace_back();
+        }
+        state = next_[slot];
+      }
+      ends[state].emplace_back(e);
+    };
+    for (std::size_t word = 0; word < words.size(); ++word) {
+      lengths_.emplace_back(static_cast<int>(words[word].size()));
+      longest_ = std::max(longest_, lengths_.back());
+      if (words[word].empty()) { continue; }
+      insert(words[word].begin(), words[word].end(), entry{word, false});
+      insert(words[word].rbegin(), words[word].rend(), entry{word, true});
+    }
+
+    // Breadth first, so a state's failure link is finished before its
+    // children need it. Missing transitions are filled in from the failure
+    // link, turning the trie into a DFA.
+    std::size_t const states = ends.size();
+    fail_.assign(states, 0);
+    output_link_.assign(states, -1);
+    order_.reserve(states);
+    order_.emplace_back(0);
+    for (std::size_t i = 0; i < order_.size(); ++i) {
+      int32_t const state = order_[i];
+      for (int symbol = 0; symbol < width_; ++symbol) {
+        int32_t& child = next_[transition(state, symbol)];
+        int32_t const fallback = state == 0 ? 0 : next_[transition(fail_[state], symbol)];
+        if (child < 0) {
+          child = fallback;
+          continue;
+        }
+        fail_[child] = fallback;
+        output_link_[child] = ends[fallback].empty() ? output_link_[fallback] : fallback;
+        order_.emplace_back(child);
+      }
+    }
+
+    entries_.reserve(states, 2 * words.size());
+    for (auto const& row : ends) { entries_.add_row(row); }
+  }
+
+  std::size_t size() const noexcept { return lengths_.size(); }
+
+  // How often each word occurs on `board`, whose rows must all be as long as
+  // the first. The board is cut into row bands, each scanned on its own
+  // after re-reading the `longest - 1` rows above it: every match ending in
+  // the band starts at most that far up. Each state counts how often a line
+  // reached it; a state's words also end wherever a state whose failure
+  // chain passes through it does, so the counts are pushed down the failure
+  // links, deepest first.
+  std::vector<int64_t> count(std::span<std::string_view const> board,
+                             thread_pool& pool = thread_pool::global()) const {
+    using visits_t = std::vector<int64_t>;
+    visits_t visits = reduce_row_bands(static_cast<int>(board.size()), std::max(0, longest_ - 1), visits_t{},
+      [&](int first, int begin, int end) {
+        visits_t band(fail_.size());
+        scan(board, first, begin, end, [&](int32_t state, int, int, int, int) { ++band[state]; });
+        return band;
+      },
+      [](visits_t acc, visits_t band) {
+        if (acc.empty()) { return band; }
+        for (std::size_t state = 0; state < acc.size(); ++state) { acc[state] += band[state]; }
+        return acc;
+      }, pool);
+    visits.resize(fail_.size());
+
+    for (std::size_t i = order_.size(); i-- > 1;) {
+      visits[fail_[order_[i]]] += visits[order_[i]];
+    }
+
+    std::vector<int64_t> res(size());
+    for (std::size_t state = 0; state < fail_.size(); ++state) {
+      for (entry e : entries_[state]) { res[e.word] += visits[state]; }
+    }
+    return res;
+  }
+
+  // Calls `on_match(match const&)` for every occurrence on `board`, in no
+  // particular order.
+  template<typename F>
+  void for_each_match(std::span<std::string_view const> board, F&& on_match) const {
+    scan(board, 0, 0, static_cast<int>(board.size()), [&](int32_t state, int row, int col, int drow, int dcol) {
+      for (int32_t s = entries_[state].empty() ? output_link_[state] : state; s >= 0; s = output_link_[s]) {
+        for (entry e : entries_[s]) {
+          if (e.reversed) {
+            on_match(match{e.word, row, col, -drow, -dcol});
+          } else {
+            int const steps = lengths_[e.word] - 1;
+            on_match(match{e.word, row - steps * drow, col - steps * dcol, drow, dcol});
+          }
+        }
+      }
+    });
+  }
+
+private:
+  struct entry {
+    std::size_t word;
+    bool reversed;
+  };
+
+  std::size_t transition(int32_t state, int symbol) const noexcept {
+    return static_cast<std::size_t>(state) * width_ + symbol;
+  }
+
+  // Calls `on_state(state, row, col, drow, dcol)` with the state each line
+  // running in direction (`drow`, `dcol`) is in after reading (`row`, `col`),
+  // for the rows `[begin, end)`. Lines start at row `first`, so the rows
+  // before `begin` only warm up the states.
+  //
+  // A diagonal continues from the cell up and to the left, so that pass runs
+  // right to left to read the previous row's state before replacing it; the
+  // anti-diagonal pass runs the other way for the same reason.
+  template<typename F>
+  void scan(std::span<std::string_view const> board, int first, int begin, int end, F&& on_state) const {
+    if (board.empty()) { return; }
+    int const cols = static_cast<int>(board[0].size());
+
+    std::vector<int32_t> down(cols), diagonal(cols), anti_diagonal(cols);
+    std::vector<uint16_t> line(cols);
+    for (int row = first; row < end; ++row) {
+      for (int col = 0; col < cols; ++col) {
+        line[col] = symbols_[static_cast<unsigned char>(board[row][col])];
+      }
+      bool const owned = row >= begin;
+
+      int32_t across = 0;
+      for (int col = 0; col < cols && owned; ++col) {
+        across = next_[transition(across, line[col])];
+        on_state(across, row, col, 0, 1);
+      }
+      for (int col = 0; col < cols; ++col) {
+        down[col] = next_[transition(down[col], line[col])];
+        if (owned) { on_state(down[col], row, col, 1, 0); }
+      }
+      for (int col = cols - 1; col >= 0; --col) {
+        diagonal[col] = next_[transition(col > 0 ? diagonal[col - 1] : 0, line[col])];
+        if (owned) { on_state(diagonal[col], row, col, 1, 1); }
+      }
+      for (int col = 0; col < cols; ++col) {
+        anti_diagonal[col] = next_[transition(col + 1 < cols ? anti_diagonal[col + 1] : 0, line[col])];
+        if (owned) { on_state(anti_diagonal[col], row, col, 1, -1); }
+      }
+    }
+  }
+
+  // Symbol 0 is every byte that appears in no word.
+  std::array<uint16_t, 256> symbols_{};
+  int width_ = 1;
+  std::vector<int32_t> next_{};
+  std::vector<int32_t> fail_{};
+  // The nearest state down the failure chain that ends a word, or -1.
+  std::vector<int32_t> output_link_{};
+  // States in breadth-first order.
+  std::vector<int32_t> order_{};
+  Jagged<entry> entries_{};
+  std::vector<int> lengths_{};
+  int longest_ = 0;
+};
+
+// Stable LSD radix sort of integers, one byte per pass; signed keys come out
+// in numeric order. A pass whose byte is the same for every key is skipped,
+// so keys that use only the low bytes of `T` cost only that many passes.
+//
+// From `radix_parallel_threshold` keys up, the array is split into one block
+// per pool thread. Each block counts its own bytes, the counts give every
+// (byte, block) pair a disjoint output range, and the blocks scatter
+// concurrently.
+inline constexpr std::size_t radix_parallel_threshold = std::size_t{1} << 16;
+
+template<std::integral T>
+void radix_sort(std::span<T> keys, thread_pool& pool = thread_pool::global()) {
+  using U = std::make_unsigned_t<T>;
+  using histogram = std::array<std::size_t, 256>;
+  constexpr std::size_t passes = sizeof(T);
+  // Flipping the sign bit maps signed order onto unsigned order.
+  constexpr U flip = std::is_signed_v<T> ? U{1} << (8 * sizeof(T) - 1) : U{0};
+
+  std::size_t const n = keys.size();
+  if (n < 2) { return; }
+  std::size_t const blocks = n >= radix_parallel_threshold ? pool.size() : 1;
+  std::size_t const block_len = (n + blocks - 1) / blocks;
+  auto block_range = [&](std::size_t block) {
+    return std::pair{std::min(n, block * block_len), std::min(n, (block + 1) * block_len)};
+  };
+  auto digit = [](T key, std::size_t pass) {
+    return static_cast<std::size_t>(((static_cast<U>(key) ^ flip) >> (8 * pass)) & 0xff);
+  };
+
+  // `counts[block * passes + pass]`, all passes counted in one read.
+  std::vector<histogram> counts(blocks * passes);
+  pool.parallel_for(0, blocks, [&](std::size_t block) {
+    auto const [begin, end] = block_range(block);
+    histogram* h = &counts[block * passes];
+    for (std::size_t i = begin; i < end; ++i) {
+      for (std::size_t pass = 0; pass < passes; ++pass) { ++h[pass][digit(keys[i], pass)]; }
+    }
+  }, 1);
+
+  // Totals don't change as keys move, so they decide up front which passes
+  // can be skipped.
+  std::array<histogram, passes> totals{};
+  for (std::size_t block = 0; block < blocks; ++block) {
+    for (std::size_t pass = 0; pass < passes; ++pass) {
+      for (std::size_t d = 0; d < 256; ++d) { totals[pass][d] += counts[block * passes + pass][d]; }
+    }
+  }
+
+  auto buffer = std::make_unique_for_overwrite<T[]>(n);
+  std::span<T> src = keys;
+  std::span<T> dst{buffer.get(), n};
+  bool scattered = false;
+  for (std::size_t pass = 0; pass < passes; ++pass) {
+    if (std::find(totals[pass].begin(), totals[pass].end(), n) != totals[pass].end()) { continue; }
+
+    // A scatter reshuffles which keys each block holds, so the per-block
+    // counts from the first read only hold until then.
+    if (scattered && blocks > 1) {
+      pool.parallel_for(0, blocks, [&](std::size_t block) {
+        auto const [begin, end] = block_range(block);
+        histogram& h = counts[block * passes + pass];
+        h.fill(0);
+        for (std::size_t i = begin; i < end; ++i) { ++h[digit(src[i], pass)]; }
+      }, 1);
+    }
+
+    std::size_t next = 0;
+    for (std::size_t d = 0; d < 256; ++d) {
+      for (std::size_t block = 0; block < blocks; ++block) {
+        std::size_t& count = counts[block * passes + pass][d];
+        std::size_t const start = next;
+        next += count;
+        count = start;
+      }
+    }
+
+    pool.parallel_for(0, blocks, [&](std::size_t block) {
+      auto const [begin, end] = block_range(block);
+      histogram& offsets = counts[block * passes + pass];
+      for (std::size_t i = begin; i < end; ++i) { dst[offsets[digit(src[i], pass)]++] = src[i]; }
+    }, 1);
+    std::swap(src, dst);
+    scattered = true;
+  }
+
+  if (src.data() != keys.data()) {
+    std::copy(src.begin(), src.end(), keys.begin());
+  }
+}
+
+// Sorts more integers than fit in memory.
+//
+// `push` buffers values in half of `memory_budget` bytes; sorting needs the
+// other half as scratch. Each full buffer is radix-sorted and spilled as one
+// run to an unlinked temporary file in `$TMPDIR` (default `/tmp`).
+//
+// `merged()` returns a cursor that yields every pushed value in sorted order
+// through a k-way merge of the runs. The cursor's read buffers split the same
+// budget between the runs, with at least a page per run. If nothing was
+// spilled, the cursor reads straight from the sorted in-memory buffer.
+// Cursors read the runs independently, so the values can be walked more than
+// once.
+template<std::integral T>
+class external_sorter {
+  struct run {
+    off_t offset;
+    std::size_t count;
+  };
+
+  // Smallest buffer worth a system call, in values.
+  static constexpr std::size_t min_block = 4096 / sizeof(T);
+
+public:
+  explicit external_sorter(std::size_t memory_budget)
+    : capacity_{std::max<std::size_t>(memory_budget / 2 / sizeof(T), 1)} {}
+
+  external_sorter(external_sorter const&) = delete;
+  external_sorter& operator=(external_sorter const&) = delete;
+
+  ~external_sorter() {
+    if (fd_ != -1) { ::close(fd_); }
+  }
+
+  void push(T value) {
+    if (buffer_.empty()) { buffer_.reserve(capacity_); }
+    buffer_.push_back(value);
+    if (buffer_.size() == capacity_) { spill(); }
+  }
+
+  std::size_t size() const noexcept { return spilled_ + buffer_.size(); }
+  std::size_t runs() const noexcept { return runs_.size(); }
+
+  class cursor {
+  public:
+    bool next(T& value) {
+      if (heap_.empty()) { return false; }
+      std::pop_heap(heap_.begin(), heap_.end(), std::greater<>{});
+      auto const [head, index] = heap_.back();
+      heap_.pop_back();
+      value = head;
+      if (advance(sources_[index])) {
+        heap_.emplace_back(sources_[index].view.front(), index);
+        std::push_heap(heap_.begin(), heap_.end(), std::greater<>{});
+      }
+      return true;
+    }
+
+  private:
+    friend class external_sorter;
+
+    // A run still on disk at `offset`, with `view` the values read so far
+    // and not yet yielded.
+    struct source {
+      off_t offset = 0;
+      std::size_t remaining = 0;
+      std::vector<T> block{};
+      std::span<T const> view{};
+    };
+
+    cursor(int fd, std::span<run const> runs, std::span<T const> in_memory, std::size_t memory_budget) : fd_{fd} {
+      std::size_t const block_len =
+        std::max<std::size_t>(memory_budget / sizeof(T) / std::max<std::size_t>(runs.size(), 1), min_block);
+      sources_.resize(runs.empty() ? 1 : runs.size());
+      if (runs.empty()) {
+        sources_[0].view = in_memory;
+      }
+      for (std::size_t i = 0; i < runs.size(); ++i) {
+        sources_[i].offset = runs[i].offset;
+        sources_[i].remaining = runs[i].count;
+        sources_[i].block.resize(std::min(block_len, runs[i].count));
+        refill(sources_[i]);
+      }
+      for (uint32_t i = 0; i < sources_.size(); ++i) {
+        if (!sources_[i].view.empty()) { heap_.emplace_back(sources_[i].view.front(), i); }
+      }
+      std::make_heap(heap_.begin(), heap_.end(), std::greater<>{});
+    }
+
+    // Drops the value just yielded from `src`; false once `src` runs dry.
+    bool advance(source& src) {
+      src.view = src.view.subspan(1);
+      if (src.view.empty() && src.remaining != 0) { refill(src); }
+      return !src.view.empty();
+    }
+
+    void refill(source& src) {
+      std::size_t const count = std::min(src.block.size(), src.remaining);
+      read_fully(fd_, src.block.data(), count * sizeof(T), src.offset);
+      src.offset += static_cast<off_t>(count * sizeof(T));
+      src.remaining -= count;
+      src.view = {src.block.data(), count};
+    }
+
+    int fd_;
+    std::vector<source> sources_{};
+    std::vector<std::pair<T, uint32_t>> heap_{};
+  };
+
+  // Sorts what is still buffered and returns a cursor over all values.
+  cursor merged() {
+    if (!runs_.empty() && !buffer_.empty()) {
+      spill();
+    }
+    if (runs_.empty()) {
+      radix_sort(std::span{buffer_});
+    } else {
+      // Every value is on disk now; release the buffer for the cursors.
+      std::vector<T>{}.swap(buffer_);
+    }
+    return cursor{fd_, runs_, buffer_, 2 * capacity_ * sizeof(T)};
+  }
+
+private:
+  void spill() {
+    if (fd_ == -1) { open_temp_file(); }
+    radix_sort(std::span{buffer_});
+    std::size_t const bytes = buffer_.size() * sizeof(T);
+    off_t const offset = runs_.empty() ? 0 : runs_.back().offset + static_cast<off_t>(runs_.back().count * sizeof(T));
+    for (std::size_t written = 0; written < bytes;) {
+      ssize_t n = ::pwrite(fd_, reinterpret_cast<char const*>(buffer_.data()) + written, bytes - written,
+                           offset + static_cast<off_t>(written));
+      if (n < 0) {
+        throw std::ios_base::failure("Failed to write sorted run");
+      }
+      written += static_cast<std::size_t>(n);
+    }
+    runs_.push_back({offset, buffer_.size()});
+    spilled_ += buffer_.size();
+    buffer_.clear();
+  }
+
+  void open_temp_file() {
+    char const* dir = std::getenv("TMPDIR");
+    std::string path = std::string{dir != nullptr && *dir != '\0' ? dir : "/tmp"} + "/aoc_runs_XXXXXX";
+    fd_ = ::mkstemp(path.data());
+    if (fd_ == -1) {
+      throw std::ios_base::failure("Failed to create temporary file: " + path);
+    }
+    // The open descriptor keeps the file alive; nothing is left behind on exit.
+    ::unlink(path.c_str());
+  }
+
+  static void read_fully(int fd, T* data, std::size_t bytes, off_t offset) {
+    for (std::size_t done = 0; done < bytes;) {
+      ssize_t n = ::pread(fd, reinterpret_cast<char*>(data) + done, bytes - done, offset + static_cast<off_t>(done));
+      if (n <= 0) {
+        throw std::ios_base::failure("Failed to read sorted run");
+      }
+      done += static_cast<std::size_t>(n);
+    }
+  }
+
+  std::size_t capacity_;
+  std::vector<T> buffer_{};
+  std::vector<run> runs_{};
+  std::size_t spilled_ = 0;
+  int fd_ = -1;
+};
+
+// Hardware performance counters for the calling thread and every worker of
+// a thread pool (plus the threads any of them spawn afterwards), read
+// through Linux `perf_event_open` and summed over the threads, so phases
+// that run on the pool are counted in full.
+//
+// The workers are counted by thread id, one set of events each: inherited
+// counts only reach the parent's events when a child exits, and the pool's
+// workers live as long as the pool.
+//
+// Every event is opened on its own, so an event the CPU or VM doesn't expose
+// is simply missing rather than taking the others down with it; an event is
+// only kept if it could be opened on every thread. When no event can be
+// opened at all (not Linux, `perf_event_paranoid` too strict, seccomp in a
+// container, ...) `available()` is false and `start`/`stop` do nothing.
+class perf_counters {
+public:
+  enum event {
+    cycles,
+    instructions,
+    branches,
+    branch_misses,
+    l1d_loads,
+    l1d_load_misses,
+    llc_references,
+    llc_misses,
+    num_events
+  };
+
+  using values = std::array<uint64_t, num_events>;
+
+  static constexpr std::array<char const*, num_events> names{
+    "cycles", "instructions", "branches", "branch_misses",
+    "l1d_loads", "l1d_load_misses", "llc_references", "llc_misses"
+  };
+
+  explicit perf_counters(thread_pool& pool = thread_pool::global()) {
+#if defined(__linux__)
+    auto cache_event = [](uint64_t cache, uint64_t result) {
+      return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (result << 16);
+    };
+    std::array<std::pair<uint32_t, uint64_t>, num_events> const configs{{
+      {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+      {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+      {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_INSTRUCTIONS},
+      {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+      {PERF_TYPE_HW_CACHE, cache_event(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_RESULT_ACCESS)},
+      {PERF_TYPE_HW_CACHE, cache_event(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_RESULT_MISS)},
+      {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_REFERENCES},
+      {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+    }};
+
+    // Thread id 0 is the calling thread.
+    std::vector<long> threads{0};
+    threads.insert(threads.end(), pool.worker_ids().begin(), pool.worker_ids().end());
+    fds_.resize(threads.size());
+    for (std::size_t t = 0; t < threads.size(); ++t) {
+      fds_[t].fill(-1);
+      for (int e = 0; e < num_events; ++e) {
+        perf_event_attr attr{};
+        attr.size = sizeof(attr);
+        attr.type = configs[e].first;
+        attr.config = configs[e].second;
+        attr.disabled = 1;
+        attr.inherit = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        fds_[t][e] = static_cast<int>(::syscall(SYS_perf_event_open, &attr, threads[t], -1, -1, 0));
+      }
+    }
+
+    // A partial sum would pass for a whole one, so an event missing on any
+    // thread is dropped everywhere.
+    for (int e = 0; e < num_events; ++e) {
+      bool const everywhere = std::all_of(fds_.cbegin(), fds_.cend(), [e](auto const& set) { return set[e] != -1; });
+      if (everywhere) { continue; }
+      for (auto& set : fds_) {
+        if (set[e] != -1) { ::close(set[e]); }
+        set[e] = -1;
+      }
+    }
+#else
+    (void)pool;
+    fds_.resize(1);
+    fds_[0].fill(-1);
+#endif
+  }
+
+  perf_counters(perf_counters const&) = delete;
+  perf_counters& operator=(perf_counters const&) = delete;
+
+  ~perf_counters() {
+    for (auto const& set : fds_) {
+      for (int fd : set) {
+        if (fd != -1) { ::close(fd); }
+      }
+    }
+  }
+
+  bool available() const noexcept {
+    return std::any_of(fds_[0].cbegin(), fds_[0].cend(), [](int fd) { return fd != -1; });
+  }
+
+  bool has(event e) const noexcept { return fds_[0][e] != -1; }
+
+  // Threads counted: the calling thread plus the pool's workers.
+  std::size_t threads() const noexcept { return fds_.size(); }
+
+  void start() noexcept {
+#if defined(__linux__)
+    for (auto const& set : fds_) {
+      for (int fd : set) {
+        if (fd == -1) { continue; }
+        ::ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ::ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+      }
+    }
+#endif
+  }
+
+  // Counts since `start()` summed over the threads, each scaled up when the
+  // kernel had to multiplex its events. Missing events read as 0.
+  values stop() noexcept {
+    values res{};
+#if defined(__linux__)
+    for (auto const& set : fds_) {
+      for (int fd : set) {
+        if (fd != -1) { ::ioctl(fd, PERF_EVENT_IOC_DISABLE, 0); }
+      }
+    }
+    for (auto const& set : fds_) {
+      for (int e = 0; e < num_events; ++e) {
+        struct { uint64_t value, time_enabled, time_running; } data{};
+        if (set[e] == -1 || ::read(set[e], &data, sizeof(data)) != sizeof(data) || data.time_running == 0) {
+          continue;
+        }
+        res[e] += data.time_running == data.time_enabled
+                    ? data.value
+                    : static_cast<uint64_t>(static_cast<double>(data.value) * data.time_enabled / data.time_running);
+      }
+    }
+#endif
+    return res;
+  }
+
+private:
+  // One set of events per counted thread, the calling thread's first.
+  std::vector<std::array<int, num_events>> fds_{};
+};
+
+// Heap accounting, fed by the counting global `operator new`/`operator delete`
+// that are compiled in when `AOC_ALLOC_STATS` is defined (see the end of this
+// file). Without it every count stays 0 and `enabled` is false.
+//
+// The counters are process-wide, so a phase's numbers include whatever else
+// the process allocates meanwhile (its own pool tasks, but also any other
+// work running at the same time). The aoc2024 driver refuses to run several
+// days at once in such a build for that reason.
+namespace alloc_stats {
+
+#if defined(AOC_ALLOC_STATS)
+inline constexpr bool enabled = true;
+#else
+inline constexpr bool enabled = false;
+#endif
+
+struct snapshot {
+  uint64_t allocations = 0;
+  uint64_t bytes = 0;
+  uint64_t live_bytes = 0;
+  uint64_t peak_live_bytes = 0;
+};
+
+struct state {
+  std::atomic<uint64_t> allocations{0};
+  std::atomic<uint64_t> bytes{0};
+  std::atomic<uint64_t> live_bytes{0};
+  std::atomic<uint64_t> peak_live_bytes{0};
+};
+
+inline state& global() {
+  // Constant-initialized, so it is usable from the very first allocation.
+  static constinit state s{};
+  return s;
+}
+
+inline void record_allocation(std::size_t size) noexcept {
+  state& s = global();
+  s.allocations.fetch_add(1, std::memory_order_relaxed);
+  s.bytes.fetch_add(size, std::memory_order_relaxed);
+  uint64_t live = s.live_bytes.fetch_add(size, std::memory_order_relaxed) + size;
+  uint64_t peak = s.peak_live_bytes.load(std::memory_order_relaxed);
+  while (live > peak && !s.peak_live_bytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {}
+}
+
+inline void record_deallocation(std::size_t size) noexcept {
+  global().live_bytes.fetch_sub(size, std::memory_order_relaxed);
+}
+
+inline snapshot take() noexcept {
+  state const& s = global();
+  return {s.allocations.load(std::memory_order_relaxed), s.bytes.load(std::memory_order_relaxed),
+          s.live_bytes.load(std::memory_order_relaxed), s.peak_live_bytes.load(std::memory_order_relaxed)};
+}
+
+// Restarts peak tracking from the current live size, so the next `take()`
+// reports the high-water mark reached since this call.
+inline void reset_peak() noexcept {
+  state& s = global();
+  s.peak_live_bytes.store(s.live_bytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+} // namespace alloc_stats
+
+// Times the phases of a solution (e.g. `parse_input`, `solve_part1`, ...).
+//
+// Benchmarking is off by default, in which case `run` just calls the phase
+// once. It is turned on through the environment:
+//
+//   AOC_BENCH=<n>         time each phase over `n` repetitions
+//   AOC_BENCH_WARMUP=<n>  untimed runs before those (default: 1)
+//   AOC_BENCH_JSON=<path> also write the results as JSON (`-` for stdout)
+//   AOC_BENCH_PERF=1      also read hardware counters around each timed run
+//                         (implies AOC_BENCH=1 when that is unset)
+//
+// Building with `-DAOC_ALLOC_STATS` also counts heap allocations, bytes and
+// the peak of live bytes above the phase's starting point for every timed
+// run (and likewise implies AOC_BENCH=1).
+//
+// A phase is run warmup + n times and the result of the last run is returned,
+// so a phase that mutates its inputs should work on a copy to keep the
+// repetitions comparable. `report()` prints min/median/p99 per phase to
+// stderr, keeping stdout for the answers, followed by per-run counter
+// averages with IPC and miss rates when counters could be opened. Otherwise
+// it notes that and reports wall-clock time only. Allocation stats, when
+// compiled in, get a table of their own.
+class benchmark {
+public:
+  using clock = std::chrono::steady_clock;
+
+  struct phase {
+    std::string name;
+    std::vector<int64_t> samples_ns;
+    perf_counters::values counter_totals{};
+    uint64_t allocations = 0;
+    uint64_t allocated_bytes = 0;
+    uint64_t peak_live_bytes = 0;
+  };
+
+  benchmark()
+    : benchmark(env_int("AOC_BENCH", env_int("AOC_BENCH_PERF", 0) != 0 || alloc_stats::enabled ? 1 : 0),
+                env_int("AOC_BENCH_WARMUP", 1),
+                std::getenv("AOC_BENCH_JSON") ? std::getenv("AOC_BENCH_JSON") : "",
+                env_int("AOC_BENCH_PERF", 0) != 0) {}
+
+  benchmark(int reps, int warmup, std::string json_path = {}, bool with_counters = false)
+    : reps_{std::max(reps, 0)}, warmup_{std::max(warmup, 0)}, json_path_{std::move(json_path)} {
+    if (with_counters && enabled()) {
+      counters_ = std::make_unique<perf_counters>();
+    }
+  }
+
+  bool enabled() const noexcept { return reps_ > 0; }
+
+  // Whether `main` should also run its alternate solvers (streaming,
+  // parallel, ...) and assert they agree with the main one: when
+  // benchmarking, to time them, and in every build with asserts on, so a
+  // plain debug run catches a regression in them too.
+  bool run_variants() const noexcept {
+#if defined(NDEBUG)
+    return enabled();
+#else
+    return true;
+#endif
+  }
+  std::vector<phase> const& phases() const noexcept { return phases_; }
+
+  // Nearest-rank percentile of an already sorted, non-empty sample.
+  static int64_t percentile(std::vector<int64_t> const& sorted, int pct) {
+    std::size_t rank = (sorted.size() * pct + 99) / 100;
+    return sorted[std::max<std::size_t>(rank, 1) - 1];
+  }
+
+  static std::string format_ns(int64_t ns) {
+    std::ostringstream oss{};
+    oss << std::fixed << std::setprecision(2);
+    if (ns < 1'000) {
+      oss << ns << " ns";
+    } else if (ns < 1'000'000) {
+      oss << ns / 1e3 << " us";
+    } else if (ns < 1'000'000'000) {
+      oss << ns / 1e6 << " ms";
+    } else {
+      oss << ns / 1e9 << " s";
+    }
+    return oss.str();
+  }
+
+  template<typename Fn>
+  std::invoke_result_t<Fn&> run(std::string_view name, Fn&& fn) {
+    using result_t = std::invoke_result_t<Fn&>;
+
+    if (!enabled()) {
+      return std::invoke(fn);
+    }
+
+    auto run_discarding = [&fn] {
+      if constexpr (std::is_void_v<result_t>) {
+        std::invoke(fn);
+      } else {
+        do_not_optimize(std::invoke(fn));
+      }
+    };
+
+    for (int i = 0; i < warmup_; ++i) {
+      run_discarding();
+    }
+
+    auto& p = phases_.emplace_back(phase{std::string{name}, {}});
+    p.samples_ns.reserve(reps_);
+    for (int i = 1; i < reps_; ++i) {
+      measure_once(p, run_discarding);
+    }
+
+    if constexpr (std::is_void_v<result_t>) {
+      measure_once(p, fn);
+    } else {
+      std::optional<result_t> result{};
+      measure_once(p, [&] { result.emplace(std::invoke(fn)); });
+      return std::move(*result);
+    }
+  }
+
+  void report() const {
+    if (!enabled() || phases_.empty()) { return; }
+
+    int name_width = 32;
+    for (auto const& p : phases_) {
+      name_width = std::max(name_width, static_cast<int>(p.name.size()) + 2);
+    }
+
+    std::ostringstream table{};
+    table << std::left << std::setw(name_width) << "phase" << std::right
+          << std::setw(8) << "runs" << std::setw(12) << "min"
+          << std::setw(12) << "median" << std::setw(12) << "p99" << '\n';
+    for (auto const& p : phases_) {
+      auto sorted = sorted_samples(p);
+      table << std::left << std::setw(name_width) << p.name << std::right
+            << std::setw(8) << sorted.size()
+            << std::setw(12) << format_ns(sorted.front())
+            << std::setw(12) << format_ns(percentile(sorted, 50))
+            << std::setw(12) << format_ns(percentile(sorted, 99)) << '\n';
+    }
+
+    if (counters_ && counters_->available()) {
+      table << "\n(counters summed over " << counters_->threads() << " thread(s): the caller and the pool workers)\n"
+            << std::left << std::setw(name_width) << "phase (per run)" << std::right
+            << std::setw(14) << "cycles" << std::setw(14) << "instructions" << std::setw(8) << "IPC"
+            << std::setw(10) << "L1D miss" << std::setw(10) << "LLC miss" << std::setw(10) << "br miss" << '\n';
+      for (auto const& p : phases_) {
+        // Missing events show up as "-" instead of a misleading zero.
+        auto cell = [&](int width, std::initializer_list<perf_counters::event> needed, auto const& value) {
+          std::ostringstream oss{};
+          oss << std::fixed;
+          bool const ok = std::all_of(needed.begin(), needed.end(), [&](auto e) { return counters_->has(e); });
+          if (ok) {
+            value(oss);
+          } else {
+            oss << '-';
+          }
+          table << std::setw(width) << oss.str();
+        };
+        auto const& c = p.counter_totals;
+        auto runs = static_cast<double>(p.samples_ns.size());
+        using e = perf_counters::event;
+        table << std::left << std::setw(name_width) << p.name << std::right;
+        cell(14, {e::cycles}, [&](auto& os) { os << std::setprecision(0) << c[e::cycles] / runs; });
+        cell(14, {e::instructions}, [&](auto& os) { os << std::setprecision(0) << c[e::instructions] / runs; });
+        cell(8, {e::instructions, e::cycles}, [&](auto& os) {
+          os << std::setprecision(2) << ratio(c[e::instructions], c[e::cycles]);
+        });
+        cell(10, {e::l1d_load_misses, e::l1d_loads}, [&](auto& os) {
+          os << std::setprecision(1) << 100 * ratio(c[e::l1d_load_misses], c[e::l1d_loads]) << '%';
+        });
+        cell(10, {e::llc_misses, e::llc_references}, [&](auto& os) {
+          os << std::setprecision(1) << 100 * ratio(c[e::llc_misses], c[e::llc_references]) << '%';
+        });
+        cell(10, {e::branch_misses, e::branches}, [&](auto& os) {
+          os << std::setprecision(1) << 100 * ratio(c[e::branch_misses], c[e::branches]) << '%';
+        });
+        table << '\n';
+      }
+    } else if (counters_) {
+      table << "(hardware counters unavailable, e.g. perf_event_paranoid or a container; wall-clock only)\n";
+    }
+
+    if constexpr (alloc_stats::enabled) {
+      table << '\n' << std::left << std::setw(name_width) << "phase (per run)" << std::right
+            << std::setw(14) << "allocations" << std::setw(16) << "bytes"
+            << std::setw(16) << "peak live" << '\n';
+      for (auto const& p : phases_) {
+        auto runs = p.samples_ns.size();
+        table << std::left << std::setw(name_width) << p.name << std::right
+              << std::setw(14) << p.allocations / runs
+              << std::setw(16) << p.allocated_bytes / runs
+              << std::setw(16) << p.peak_live_bytes << '\n';
+      }
+    }
+    std::cerr << table.str();
+
+    if (json_path_.empty()) { return; }
+
+    std::ostringstream json{};
+    json << "{\"warmup\":" << warmup_ << ",\"phases\":[";
+    for (std::size_t i = 0; i < phases_.size(); ++i) {
+      auto sorted = sorted_samples(phases_[i]);
+      json << (i == 0 ? "" : ",")
+           << "{\"name\":\"" << json_escape(phases_[i].name) << '"'
+           << ",\"runs\":" << sorted.size()
+           << ",\"min_ns\":" << sorted.front()
+           << ",\"median_ns\":" << percentile(sorted, 50)
+           << ",\"p99_ns\":" << percentile(sorted, 99)
+           << ",\"max_ns\":" << sorted.back();
+      if (counters_ && counters_->available()) {
+        json << ",\"counters\":{";
+        for (int e = 0; e < perf_counters::num_events; ++e) {
+          json << (e == 0 ? "" : ",") << '"' << perf_counters::names[e] << "\":"
+               << (counters_->has(static_cast<perf_counters::event>(e))
+                     ? std::to_string(phases_[i].counter_totals[e] / sorted.size())
+                     : "null");
+        }
+        json << '}';
+      }
+      if constexpr (alloc_stats::enabled) {
+        auto runs = sorted.size();
+        json << ",\"allocations\":" << phases_[i].allocations / runs
+             << ",\"allocated_bytes\":" << phases_[i].allocated_bytes / runs
+             << ",\"peak_live_bytes\":" << phases_[i].peak_live_bytes;
+      }
+      json << '}';
+    }
+    json << "]}\n";
+
+    if (json_path_ == "-") {
+      std::cout << json.str();
+    } else if (std::ofstream ofs{json_path_}; ofs.is_open()) {
+      ofs << json.str();
+    } else {
+      std::cerr << "Failed to write benchmark results to " << json_path_ << '\n';
+    }
+  }
+
+private:
+  // Keeps the compiler from dropping a phase whose result is thrown away.
+  template<typename T>
+  static void do_not_optimize(T const& value) {
+    asm volatile("" : : "r"(&value) : "memory");
+  }
+
+  static int env_int(char const* name, int fallback) {
+    char const* value = std::getenv(name);
+    return value != nullptr && *value != '\0' ? std::atoi(value) : fallback;
+  }
+
+  template<typename Fn>
+  void measure_once(phase& p, Fn&& fn) {
+    alloc_stats::reset_peak();
+    auto const allocs_before = alloc_stats::take();
+    if (counters_) { counters_->start(); }
+    auto start = clock::now();
+    std::invoke(fn);
+    auto elapsed = clock::now() - start;
+    auto const allocs_after = alloc_stats::take();
+    p.allocations += allocs_after.allocations - allocs_before.allocations;
+    p.allocated_bytes += allocs_after.bytes - allocs_before.bytes;
+    p.peak_live_bytes = std::max(p.peak_live_bytes, allocs_after.peak_live_bytes - allocs_before.live_bytes);
+    if (counters_) {
+      auto counts = counters_->stop();
+      for (int e = 0; e < perf_counters::num_events; ++e) {
+        p.counter_totals[e] += counts[e];
+      }
+    }
+    p.samples_ns.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+  }
+
+  static double ratio(uint64_t num, uint64_t den) {
+    return den == 0 ? 0.0 : static_cast<double>(num) / den;
+  }
+
+  static std::vector<int64_t> sorted_samples(phase const& p) {
+    std::vector<int64_t> sorted{p.samples_ns};
+    std::sort(sorted.begin(), sorted.end());
+    return sorted;
+  }
+
+  static std::string json_escape(std::string_view s) {
+    std::string res{};
+    for (char c : s) {
+      if (c == '"' || c == '\\') { res += '\\'; }
+      res += c;
+    }
+    return res;
+  }
+
+  int reps_;
+  int warmup_;
+  std::string json_path_;
+  std::unique_ptr<perf_counters> counters_{};
+  std::vector<phase> phases_{};
+};
+
+// The answers of one day, formatted for printing.
+struct solution {
+  std::string part1;
+  std::string part2;
+};
+
+// Every day exposes `solution solve(std::string_view input)`. When built with
+// `AOC_DRIVER`, a day skips its own `main` and registers `solve` here instead,
+// so the `aoc2024` driver can run any set of days in one process:
+//
+//   helper::register_day const registration{1, solve};
+using solver = solution (*)(std::string_view input);
+
+inline std::map<int, solver>& registered_days() {
+  static std::map<int, solver> days{};
+  return days;
+}
+
+struct register_day {
+  register_day(int day, solver fn) { registered_days().emplace(day, fn); }
+};
+
+// Hot-path instrumentation: scoped zone timers and named event counters.
+//
+// Both compile to nothing unless `AOC_INSTRUMENT` is defined, so they can stay
+// in inner loops:
+//
+//   AOC_ZONE("will_guard_loop");          // times the enclosing scope
+//   AOC_COUNT("will_guard_loop.steps");   // += 1
+//   AOC_COUNT_ADD("visited.bytes", n);    // += n
+//
+// Each thread accumulates into its own buffer, indexed by a per-site id, so
+// recording never takes a lock. All buffers are summed and printed to stderr
+// at exit.
+namespace instrument {
+
+enum class site_kind { counter, zone };
+
+struct slot {
+  uint64_t count = 0;
+  uint64_t total_ns = 0;
+};
+
+class registry {
+public:
+  static registry& instance() {
+    static registry r{};
+    return r;
+  }
+
+  int add_site(char const* name, site_kind kind) {
+    std::lock_guard lock{mutex_};
+    sites_.push_back({name, kind});
+    return static_cast<int>(sites_.size()) - 1;
+  }
+
+  std::shared_ptr<std::vector<slot>> add_thread_buffer() {
+    std::lock_guard lock{mutex_};
+    return buffers_.emplace_back(std::make_shared<std::vector<slot>>());
+  }
+
+  ~registry() { print_summary(); }
+
+private:
+  struct site {
+    char const* name;
+    site_kind kind;
+  };
+
+  registry() = default;
+
+  void print_summary() {
+    std::lock_guard lock{mutex_};
+    if (sites_.empty()) { return; }
+
+    // Sites sharing a name (e.g. the same counter bumped from two places) are
+    // reported together.
+    std::vector<std::pair<std::string_view, slot>> counters{};
+    std::vector<std::pair<std::string_view, slot>> zones{};
+    for (std::size_t id = 0; id < sites_.size(); ++id) {
+      slot sum{};
+      for (auto const& buffer : buffers_) {
+        if (id < buffer->size()) {
+          sum.count += (*buffer)[id].count;
+          sum.total_ns += (*buffer)[id].total_ns;
+        }
+      }
+
+      auto& target = sites_[id].kind == site_kind::counter ? counters : zones;
+      auto it = std::find_if(target.begin(), target.end(), [&](auto const& e) { return e.first == sites_[id].name; });
+      if (it == target.end()) {
+        target.emplace_back(sites_[id].name, sum);
+      } else {
+        it->second.count += sum.count;
+        it->second.total_ns += sum.total_ns;
+      }
+    }
+
+    std::ostringstream oss{};
+    if (!counters.empty()) {
+      oss << std::left << std::setw(40) << "counter" << std::right << std::setw(16) << "count" << '\n';
+      for (auto const& [name, sum] : counters) {
+        oss << std::left << std::setw(40) << name << std::right << std::setw(16) << sum.count << '\n';
+      }
+    }
+    if (!zones.empty()) {
+      oss << std::left << std::setw(40) << "zone" << std::right << std::setw(16) << "calls"
+          << std::setw(16) << "total ms" << std::setw(16) << "mean ns" << '\n';
+      for (auto const& [name, sum] : zones) {
+        oss << std::left << std::setw(40) << name << std::right << std::setw(16) << sum.count
+            << std::setw(16) << std::fixed << std::setprecision(3) << sum.total_ns / 1e6
+            << std::setw(16) << std::setprecision(1) << (sum.count == 0 ? 0.0 : double(sum.total_ns) / sum.count) << '\n';
+      }
+    }
+    std::cerr << oss.str();
+  }
+
+  std::mutex mutex_{};
+  std::vector<site> sites_{};
+  std::vector<std::shared_ptr<std::vector<slot>>> buffers_{};
+};
+
+// One per instrumentation site, created on first execution of that site.
+struct site_id {
+  site_id(char const* name, site_kind kind) : id{registry::instance().add_site(name, kind)} {}
+  int id;
+};
+
+inline slot& local_slot(int id) {
+  // The registry shares ownership, so counts survive the thread that made them.
+  thread_local std::shared_ptr<std::vector<slot>> buffer = registry::instance().add_thread_buffer();
+  if (static_cast<std::size_t>(id) >= buffer->size()) {
+    buffer->resize(id + 1);
+  }
+  return (*buffer)[id];
+}
+
+class zone {
+public:
+  explicit zone(site_id const& site) : id_{site.id}, start_{std::chrono::steady_clock::now()} {}
+
+  zone(zone const&) = delete;
+  zone& operator=(zone const&) = delete;
+
+  ~zone() {
+    auto elapsed = std::chrono::steady_clock::now() - start_;
+    slot& s = local_slot(id_);
+    ++s.count;
+    s.total_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+  }
+
+private:
+  int id_;
+  std::chrono::steady_clock::time_point start_;
+};
+
+} // namespace instrument
+
 } // namespace helper
+
+#define AOC_CONCAT_IMPL(a, b) a##b
+#define AOC_CONCAT(a, b) AOC_CONCAT_IMPL(a, b)
+
+#if defined(AOC_INSTRUMENT)
+#define AOC_ZONE(name)                                                                        \
+  static ::helper::instrument::site_id const AOC_CONCAT(aoc_zone_site_, __LINE__){            \
+    name, ::helper::instrument::site_kind::zone};                                             \
+  ::helper::instrument::zone const AOC_CONCAT(aoc_zone_, __LINE__){AOC_CONCAT(aoc_zone_site_, __LINE__)}
+#define AOC_COUNT_ADD(name, n)                                                                \
+  do {                                                                                        \
+    static ::helper::instrument::site_id const aoc_counter_site{                              \
+      name, ::helper::instrument::site_kind::counter};                                        \
+    ::helper::instrument::local_slot(aoc_counter_site.id).count += (n);                       \
+  } while (0)
+#else
+#define AOC_ZONE(name) static_cast<void>(0)
+#define AOC_COUNT_ADD(name, n) static_cast<void>(0)
+#endif
+
+#define AOC_COUNT(name) AOC_COUNT_ADD(name, 1)
+
+#if defined(AOC_ALLOC_STATS)
+
+// Counting replacements for the global allocation functions. Each block
+// carries a small header recording its size and the header's own length, so
+// unsized and aligned deletes can find both.
+namespace helper::alloc_stats {
+
+inline void* counted_allocate(std::size_t size, std::size_t alignment) noexcept {
+  std::size_t const header = std::max(alignment, alignof(std::max_align_t));
+  std::size_t const total = header + size;
+  void* raw = alignment > alignof(std::max_align_t)
+                ? std::aligned_alloc(alignment, (total + alignment - 1) / alignment * alignment)
+                : std::malloc(total);
+  if (raw == nullptr) { return nullptr; }
+
+  char* user = static_cast<char*>(raw) + header;
+  reinterpret_cast<std::size_t*>(user)[-1] = size;
+  reinterpret_cast<std::size_t*>(user)[-2] = header;
+  record_allocation(size);
+  return user;
+}
+
+inline void counted_deallocate(void* ptr) noexcept {
+  if (ptr == nullptr) { return; }
+
+  char* user = static_cast<char*>(ptr);
+  record_deallocation(reinterpret_cast<std::size_t*>(user)[-1]);
+  std::free(user - reinterpret_cast<std::size_t*>(user)[-2]);
+}
+
+inline void* counted_allocate_or_throw(std::size_t size, std::size_t alignment) {
+  void* ptr = counted_allocate(size, alignment);
+  if (ptr == nullptr) { throw std::bad_alloc{}; }
+  return ptr;
+}
+
+} // namespace helper::alloc_stats
+
+// Replacement allocation functions must be defined exactly once per program,
+// so in the multi-day driver only the translation unit defining
+// `AOC_DRIVER_MAIN` gets them.
+#if !defined(AOC_DRIVER) || defined(AOC_DRIVER_MAIN)
+
+void* operator new(std::size_t size) {
+  return helper::alloc_stats::counted_allocate_or_throw(size, alignof(std::max_align_t));
+}
+void* operator new[](std::size_t size) {
+  return helper::alloc_stats::counted_allocate_or_throw(size, alignof(std::max_align_t));
+}
+void* operator new(std::size_t size, std::align_val_t al) {
+  return helper::alloc_stats::counted_allocate_or_throw(size, static_cast<std::size_t>(al));
+}
+void* operator new[](std::size_t size, std::align_val_t al) {
+  return helper::alloc_stats::counted_allocate_or_throw(size, static_cast<std::size_t>(al));
+}
+void* operator new(std::size_t size, std::nothrow_t const&) noexcept {
+  return helper::alloc_stats::counted_allocate(size, alignof(std::max_align_t));
+}
+void* operator new[](std::size_t size, std::nothrow_t const&) noexcept {
+  return helper::alloc_stats::counted_allocate(size, alignof(std::max_align_t));
+}
+void* operator new(std::size_t size, std::align_val_t al, std::nothrow_t const&) noexcept {
+  return helper::alloc_stats::counted_allocate(size, static_cast<std::size_t>(al));
+}
+void* operator new[](std::size_t size, std::align_val_t al, std::nothrow_t const&) noexcept {
+  return helper::alloc_stats::counted_allocate(size, static_cast<std::size_t>(al));
+}
+
+void operator delete(void* ptr) noexcept { helper::alloc_stats::counted_deallocate(ptr); }
+void operator delete[](void* ptr) noexcept { helper::alloc_stats::counted_deallocate(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { helper::alloc_stats::counted_deallocate(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { helper::alloc_stats::counted_deallocate(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept { helper::alloc_stats::counted_deallocate(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { helper::alloc_stats::counted_deallocate(ptr); }
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept { helper::alloc_stats::counted_deallocate(ptr); }
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept { helper::alloc_stats::counted_deallocate(ptr); }
+void operator delete(void* ptr, std::nothrow_t const&) noexcept { helper::alloc_stats::counted_deallocate(ptr); }
+void operator delete[](void* ptr, std::nothrow_t const&) noexcept { helper::alloc_stats::counted_deallocate(ptr); }
+void operator delete(void* ptr, std::align_val_t, std::nothrow_t const&) noexcept { helper::alloc_stats::counted_deallocate(ptr); }
+void operator delete[](void* ptr, std::align_val_t, std::nothrow_t const&) noexcept { helper::alloc_stats::counted_deallocate(ptr); }
+
+#endif // !AOC_DRIVER || AOC_DRIVER_MAIN
+
+#endif // AOC_ALLOC_STATS
@@ -2,24 +2,30 @@
 //
 // clang++ -std=gnu++20 -stdlib=libc++ main.cpp -o main && ./main && rm main
 
+#include <cstdint>
+#include <cstdlib>
 #include <string>
-#include <sstream>
+#include <string_view>
+#include <span>
 #include <vector>
+#include <tuple>
+#include <utility>
 #include <algorithm>
-#include <unordered_map>
 #include <iostream>
 #include <cassert>
 
 #include "../aoc.h"
 
-std::pair<std::vector<int>, std::vector<int>> parse_input() {
-  std::ifstream ifs{helper::read_file_as_stream("input.txt")};
+namespace {
+
+std::pair<std::vector<int>, std::vector<int>> parse_input(std::string_view input) {
+  helper::number_scanner scanner{input};
 
   std::vector<int> left_list{};
   std::vector<int> right_list{};
   int location_id;
   bool push_left = true;
-  while (ifs >> location_id) {
+  while (scanner.next(location_id)) {
     if (push_left) {
       left_list.emplace_back(location_id);
     } else {
@@ -32,42 +38,155 @@ std::pair<std::vector<int>, std::vector<int>> parse_input() {
   return {left_list, right_list};
 }
 
-int calculate_total_distance(std::vector<int>& left_list, std::vector<int>& right_list) {
-  std::sort(left_list.begin(), left_list.end());
-  std::sort(right_list.begin(), right_list.end());
+// Both parts walk the lists in sorted order. Location ids are small
+// non-negative integers, so a radix sort needs only a few passes.
+void sort_location_lists(std::vector<int>& left_list, std::vector<int>& right_list) {
+  helper::radix_sort(std::span{left_list});
+  helper::radix_sort(std::span{right_list});
+}
+
+// Both lists must be sorted.
+int64_t calculate_total_distance(std::span<int const> left_list, std::span<int const> right_list) {
+  return helper::simd::abs_diff_sum(left_list.data(), right_list.data(), std::min(left_list.size(), right_list.size()));
+}
 
-  int total_distance = 0;
-  for (auto left_it = left_list.cbegin(), right_it = right_list.cbegin();
-       left_it != left_list.cend() && right_it != right_list.cend();
-       ++left_it, ++right_it) {
-    total_distance += std::abs(*left_it - *right_it);
+// Both lists must be sorted, so equal ids form one run in each list and a
+// single merge walk pairs every left run with its matching right run.
+int64_t calculate_similarity_score(std::span<int const> left_list, std::span<int const> right_list) {
+  int64_t similarity_score = 0;
+  auto left_it = left_list.begin();
+  auto right_it = right_list.begin();
+  while (left_it != left_list.end() && right_it != right_list.end()) {
+    if (*left_it < *right_it) {
+      ++left_it;
+    } else if (*right_it < *left_it) {
+      ++right_it;
+    } else {
+      int const id = *left_it;
+      int64_t left_count = 0;
+      int64_t right_count = 0;
+      for (; left_it != left_list.end() && *left_it == id; ++left_it) { ++left_count; }
+      for (; right_it != right_list.end() && *right_it == id; ++right_it) { ++right_count; }
+      similarity_score += id * left_count * right_count;
+    }
   }
 
-  return total_distance;
+  return similarity_score;
 }
 
-int calculate_similarity_score(std::vector<int>& left_list, std::vector<int>& right_list) {
-  std::unordered_map<int, int> right_list_freq{};
-  for (auto elem : right_list) {
-    ++right_list_freq[elem];
+// External-memory variant for lists larger than memory. Both lists are
+// streamed into `helper::external_sorter`s that share `memory_budget`, and are
+// then walked in sorted order twice: by position for the distance, by value
+// for the similarity score.
+[[maybe_unused]] std::pair<int64_t, int64_t> calculate_distance_and_similarity_external(helper::chunk_reader& reader,
+                                                                                        std::size_t memory_budget) {
+  helper::external_sorter<int> left_list{memory_budget / 2};
+  helper::external_sorter<int> right_list{memory_budget / 2};
+  reader.for_each_line([&](std::string_view line) {
+    helper::number_scanner scanner{line};
+    int left_id;
+    int right_id;
+    if (scanner.next(left_id) && scanner.next(right_id)) {
+      left_list.push(left_id);
+      right_list.push(right_id);
+    }
+  });
+
+  int64_t total_distance = 0;
+  {
+    auto left = left_list.merged();
+    auto right = right_list.merged();
+    for (int left_id, right_id; left.next(left_id) && right.next(right_id);) {
+      total_distance += std::abs(int64_t{left_id} - right_id);
+    }
   }
 
-  int similarity_score = 0;
-  for (auto elem : left_list) {
-    similarity_score += elem * right_list_freq[elem];
+  int64_t similarity_score = 0;
+  {
+    auto left = left_list.merged();
+    auto right = right_list.merged();
+    int left_id = 0;
+    int right_id = 0;
+    bool has_left = left.next(left_id);
+    bool has_right = right.next(right_id);
+    while (has_left && has_right) {
+      if (left_id < right_id) {
+        has_left = left.next(left_id);
+      } else if (right_id < left_id) {
+        has_right = right.next(right_id);
+      } else {
+        int const id = left_id;
+        int64_t left_count = 0;
+        int64_t right_count = 0;
+        for (; has_left && left_id == id; has_left = left.next(left_id)) { ++left_count; }
+        for (; has_right && right_id == id; has_right = right.next(right_id)) { ++right_count; }
+        similarity_score += id * left_count * right_count;
+      }
+    }
   }
 
-  return similarity_score;
+  return {total_distance, similarity_score};
+}
+
+[[maybe_unused]] helper::solution solve(std::string_view input) {
+  auto [left_list, right_list] = parse_input(input);
+  sort_location_lists(left_list, right_list);
+  int64_t total_distance = calculate_total_distance(left_list, right_list);
+  int64_t similarity_score = calculate_similarity_score(left_list, right_list);
+  return {std::to_string(total_distance), std::to_string(similarity_score)};
 }
 
-int main() {
-  auto [left_list, right_list] = parse_input();
+} // namespace
+
+#if defined(AOC_DRIVER)
+helper::register_day const registration{1, solve};
+#else
+int main(int argc, char* argv[]) {
+  // `./main <path> [MiB]` (`-` for stdin) sorts that input on disk within a
+  // memory budget of `MiB` (default 256) instead of solving `input.txt`.
+  if (argc > 1) {
+    std::size_t const budget_mib = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 256;
+    helper::chunk_reader reader{argv[1]};
+    auto [total_distance, similarity_score] = calculate_distance_and_similarity_external(reader, budget_mib << 20);
+    std::cout << "Total distance: " << total_distance << '\n';
+    std::cout << "Similarity score: " << similarity_score << '\n';
+    return 0;
+  }
+
+  helper::mapped_file const file{"input.txt", helper::mapped_file::access_hint::sequential};
+  helper::benchmark bench{};
 
-  int total_distance = calculate_total_distance(left_list, right_list);
+  auto [left_list, right_list] = bench.run("parse_input", [&] { return parse_input(file.view()); });
+
+  // Sorting happens in place, so every repetition sorts a fresh copy.
+  std::tie(left_list, right_list) = bench.run("sort_location_lists", [&] {
+    auto left{left_list};
+    auto right{right_list};
+    sort_location_lists(left, right);
+    return std::pair{std::move(left), std::move(right)};
+  });
+
+  int64_t total_distance = bench.run("calculate_total_distance", [&] {
+    return calculate_total_distance(left_list, right_list);
+  });
   assert(total_distance == 1603498);
   std::cout << "Total distance: "<< total_distance << '\n';
 
-  int similarity_score = calculate_similarity_score(left_list, right_list);
+  int64_t similarity_score = bench.run("calculate_similarity_score", [&] {
+    return calculate_similarity_score(left_list, right_list);
+  });
   assert(similarity_score == 25574739);
   std::cout << "Similarity score: " << similarity_score << '\n';
+
+  if (bench.run_variants()) {
+    // A 1 KiB budget spills each list of the puzzle input into 16 runs.
+    [[maybe_unused]] auto external_results = bench.run("calculate_distance_and_similarity_external", [] {
+      helper::chunk_reader reader{"input.txt"};
+      return calculate_distance_and_similarity_external(reader, std::size_t{1} << 10);
+    });
+    assert(external_results == std::pair(total_distance, similarity_score));
+  }
+
+  bench.report();
 }
+#endif
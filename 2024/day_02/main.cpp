@@ -2,97 +2,317 @@
 //
 // clang++ -std=gnu++20 -stdlib=libc++ main.cpp -o main && ./main && rm main
 
+#include <cstdint>
 #include <iostream>
+#include <span>
+#include <array>
 #include <string>
+#include <string_view>
 #include <vector>
-#include <sstream>
-#include <numeric>
+#include <algorithm>
+#include <bit>
 #include <cassert>
 
 #include "../aoc.h"
 
-std::vector<std::vector<int>> parse_input() {
-  std::ifstream ifs{helper::read_file_as_stream("input.txt")};
+namespace {
 
-  std::vector<std::vector<int>> reports;
-  std::string report_str;
-  while (std::getline(ifs, report_str)) {
-    std::vector<int> report;
-    std::istringstream iss2(report_str);
-    int level;
-    while (iss2 >> level) {
-      report.emplace_back(level);
-    }
+helper::Jagged<int> parse_input(std::string_view input) {
+  helper::number_scanner scanner{input};
 
-    if (!report.empty()) {
-      reports.push_back(std::move(report));
+  helper::Jagged<int> reports;
+  int level;
+  while (scanner.next(level)) {
+    if (reports.empty() || scanner.newline_before()) {
+      reports.start_row();
     }
+    reports.push_back(level);
   }
 
   return reports;
 }
 
-bool is_sequence_safe(std::vector<int> const& report, int skip_index = -1) {
-  if (report.size() - (skip_index != -1 ? 1 : 0) < 2) {
+// Whether the levels seen so far can be made safe in one direction (+1 for
+// increasing, -1 for decreasing), tracked for the prefix that ends at the
+// current level with that level kept.
+struct dampener_state {
+  int dir;
+  // Nothing dropped, and every step is safe.
+  bool intact = true;
+  // Exactly one earlier level dropped, and every remaining step is safe.
+  bool dampened = false;
+  // `intact` one level back. Before the second level it stands for
+  // dropping the first one.
+  bool intact_before = true;
+
+  bool is_safe_step(int from, int to) const {
+    int const diff = (to - from) * dir;
+    return diff >= 1 && diff <= 3;
+  }
+
+  // Extends the prefix by `report[i]`, for `i >= 1`.
+  void advance(std::span<int const> report, std::size_t i) {
+    bool const step = is_safe_step(report[i - 1], report[i]);
+    bool const skip_step = i < 2 || is_safe_step(report[i - 2], report[i]);
+    bool const next_dampened = (dampened && step) || (intact_before && skip_step);
+    intact_before = intact;
+    intact = intact && step;
+    dampened = next_dampened;
+  }
+
+  // Nothing later can fix this prefix.
+  bool dead() const { return !intact && !dampened && !intact_before; }
+
+  // Whether the whole report of `size` levels is safe in this direction once
+  // at most one level is dropped. At least two levels must remain.
+  bool safe(std::size_t size) const {
+    return intact || (size >= 3 && (dampened || intact_before));
+  }
+};
+
+// Single pass over the report for both directions at once: a level may be
+// dropped either to bridge two neighbours (`dampened`) or at the very end
+// (`intact_before`).
+bool is_report_safe_with_dampener(std::span<int const> report) {
+  if (report.size() < 2) {
     return false;
   }
 
-  int prev = -1;
-  bool is_asc = true;
-  bool order_set = false;
-  for (size_t i = 0; i < report.size(); ++i) {
-    if (i == skip_index) {
-      continue;
+  dampener_state ascending{1};
+  dampener_state descending{-1};
+  for (std::size_t i = 1; i < report.size(); ++i) {
+    ascending.advance(report, i);
+    descending.advance(report, i);
+    if (ascending.dead() && descending.dead()) {
+      return false;
     }
+  }
 
-    if (prev != -1) {
-      int diff = report[i] - report[prev];
-      if (diff == 0) {
-        return false;
-      }
-
-      if (!order_set) {
-        is_asc = diff > 0;
-        order_set = true;
-      }
-
-      if (is_asc && (diff < 1 || diff > 3)) {
-        return false;
-      }
-      if (!is_asc && (diff > -1 || diff < -3)) {
-        return false;
-      }
-    }
+  return ascending.safe(report.size()) || descending.safe(report.size());
+}
+
+// Short reports are checked several at a time, one report per 32-bit lane,
+// by running `dampener_state`'s recurrence on lane masks. A block holds up to
+// `block_reports` reports of at most `block_levels` levels, transposed so
+// that level `j` of every report in the block sits in one vector.
+constexpr std::size_t block_levels = 8;
+constexpr std::size_t block_reports = 8;
+
+struct report_block {
+  // `levels[j][k]` is level `j` of report `k`.
+  alignas(32) std::array<std::array<int32_t, block_reports>, block_levels> levels{};
+  // Report lengths; 0 marks an unused lane.
+  alignas(32) std::array<int32_t, block_reports> sizes{};
+};
+
+#if defined(__AVX2__)
+
+struct lanes {
+  using reg = __m256i;
+  static constexpr std::size_t width = 8;
+  static reg load(int32_t const* p) { return _mm256_load_si256(reinterpret_cast<reg const*>(p)); }
+  static reg set1(int32_t v) { return _mm256_set1_epi32(v); }
+  static reg sub(reg a, reg b) { return _mm256_sub_epi32(a, b); }
+  static reg gt(reg a, reg b) { return _mm256_cmpgt_epi32(a, b); }
+  static reg and_(reg a, reg b) { return _mm256_and_si256(a, b); }
+  static reg or_(reg a, reg b) { return _mm256_or_si256(a, b); }
+  static reg andnot(reg a, reg b) { return _mm256_andnot_si256(a, b); }
+  static uint32_t movemask(reg m) { return _mm256_movemask_ps(_mm256_castsi256_ps(m)); }
+};
+
+#elif defined(__SSE2__)
+
+struct lanes {
+  using reg = __m128i;
+  static constexpr std::size_t width = 4;
+  static reg load(int32_t const* p) { return _mm_load_si128(reinterpret_cast<reg const*>(p)); }
+  static reg set1(int32_t v) { return _mm_set1_epi32(v); }
+  static reg sub(reg a, reg b) { return _mm_sub_epi32(a, b); }
+  static reg gt(reg a, reg b) { return _mm_cmpgt_epi32(a, b); }
+  static reg and_(reg a, reg b) { return _mm_and_si128(a, b); }
+  static reg or_(reg a, reg b) { return _mm_or_si128(a, b); }
+  static reg andnot(reg a, reg b) { return _mm_andnot_si128(a, b); }
+  static uint32_t movemask(reg m) { return _mm_movemask_ps(_mm_castsi128_ps(m)); }
+};
 
-    prev = i;
+#elif defined(__ARM_NEON)
+
+struct lanes {
+  using reg = int32x4_t;
+  static constexpr std::size_t width = 4;
+  static reg load(int32_t const* p) { return vld1q_s32(p); }
+  static reg set1(int32_t v) { return vdupq_n_s32(v); }
+  static reg sub(reg a, reg b) { return vsubq_s32(a, b); }
+  static reg gt(reg a, reg b) { return vreinterpretq_s32_u32(vcgtq_s32(a, b)); }
+  static reg and_(reg a, reg b) { return vandq_s32(a, b); }
+  static reg or_(reg a, reg b) { return vorrq_s32(a, b); }
+  static reg andnot(reg a, reg b) { return vbicq_s32(b, a); }
+  static uint32_t movemask(reg m) {
+    uint32x4_t const weights{1, 2, 4, 8};
+    return vaddvq_u32(vandq_u32(vreinterpretq_u32_s32(m), weights));
   }
+};
+
+#endif
+
+#if defined(__AVX2__) || defined(__SSE2__) || defined(__ARM_NEON)
 
-  return true;
+// Bit `k` is set if report `first + k` of `block` is safe.
+uint32_t safe_lanes(report_block const& block, std::size_t first) {
+  using reg = lanes::reg;
+  reg const all = lanes::set1(-1);
+  reg const none = lanes::set1(0);
+  auto blend = [](reg mask, reg a, reg b) { return lanes::or_(lanes::and_(mask, a), lanes::andnot(mask, b)); };
+  auto in_range = [](reg diff, int32_t lo, int32_t hi) {
+    return lanes::and_(lanes::gt(diff, lanes::set1(lo - 1)), lanes::gt(lanes::set1(hi + 1), diff));
+  };
+
+  struct state {
+    reg intact;
+    reg dampened;
+    reg intact_before;
+  };
+  state ascending{all, none, all};
+  state descending{all, none, all};
+  auto advance = [&](state& s, reg active, reg step, reg skip_step) {
+    reg const next_dampened = lanes::or_(lanes::and_(s.dampened, step), lanes::and_(s.intact_before, skip_step));
+    s.intact_before = blend(active, s.intact, s.intact_before);
+    s.intact = blend(active, lanes::and_(s.intact, step), s.intact);
+    s.dampened = blend(active, next_dampened, s.dampened);
+  };
+
+  reg const sizes = lanes::load(&block.sizes[first]);
+  reg before_prev = none;
+  reg prev = lanes::load(&block.levels[0][first]);
+  for (std::size_t j = 1; j < block_levels; ++j) {
+    reg const curr = lanes::load(&block.levels[j][first]);
+    // Lanes whose report is shorter keep their final state.
+    reg const active = lanes::gt(sizes, lanes::set1(static_cast<int32_t>(j)));
+    reg const diff = lanes::sub(curr, prev);
+    reg const skip_diff = lanes::sub(curr, before_prev);
+    advance(ascending, active, in_range(diff, 1, 3), j < 2 ? all : in_range(skip_diff, 1, 3));
+    advance(descending, active, in_range(diff, -3, -1), j < 2 ? all : in_range(skip_diff, -3, -1));
+    before_prev = prev;
+    prev = curr;
+  }
+
+  reg const at_least_2 = lanes::gt(sizes, lanes::set1(1));
+  reg const at_least_3 = lanes::gt(sizes, lanes::set1(2));
+  auto safe = [&](state const& s) {
+    return lanes::or_(s.intact, lanes::and_(at_least_3, lanes::or_(s.dampened, s.intact_before)));
+  };
+  return lanes::movemask(lanes::and_(at_least_2, lanes::or_(safe(ascending), safe(descending))));
 }
 
-bool is_report_safe_with_dampener(std::vector<int> const& report) {
-  if (is_sequence_safe(report)) {
-    return true;
+int count_safe_reports(report_block const& block) {
+  int count = 0;
+  for (std::size_t first = 0; first < block_reports; first += lanes::width) {
+    count += std::popcount(safe_lanes(block, first));
   }
+  return count;
+}
+
+#else
+
+int count_safe_reports(report_block const& block) {
+  int count = 0;
+  std::array<int, block_levels> report{};
+  for (std::size_t k = 0; k < block_reports; ++k) {
+    for (std::size_t j = 0; j < block_levels; ++j) { report[j] = block.levels[j][k]; }
+    count += is_report_safe_with_dampener(std::span{report}.first(block.sizes[k])) ? 1 : 0;
+  }
+  return count;
+}
+
+#endif
 
-  for (size_t i = 0; i < report.size(); ++i) {
-    if (is_sequence_safe(report, i)) {
-      return true;
+// Reports longer than a block allows take the scalar path.
+int calculate_safe_reports_num(helper::Jagged<int> const& reports) {
+  int count = 0;
+  report_block block{};
+  std::size_t filled = 0;
+  for (auto report : reports) {
+    if (report.size() > block_levels || report.empty()) {
+      count += is_report_safe_with_dampener(report) ? 1 : 0;
+      continue;
+    }
+
+    // A fixed-length copy (repeating the last level into the padding)
+    // unrolls into straight-line moves; the padding lanes are never active.
+    std::size_t const last = report.size() - 1;
+    for (std::size_t j = 0; j < block_levels; ++j) { block.levels[j][filled] = report[std::min(j, last)]; }
+    block.sizes[filled] = static_cast<int32_t>(report.size());
+    if (++filled == block_reports) {
+      count += count_safe_reports(block);
+      filled = 0;
     }
   }
 
-  return false;
+  if (filled != 0) {
+    std::fill(block.sizes.begin() + filled, block.sizes.end(), 0);
+    count += count_safe_reports(block);
+  }
+
+  return count;
 }
 
-int calculate_safe_reports_num(std::vector<std::vector<int>> const& reports) {
-  return std::transform_reduce(reports.cbegin(), reports.cend(), 0, std::plus<int>{}, [](auto const& report) {
-    return is_report_safe_with_dampener(report) ? 1 : 0;
+// Line-at-a-time counterpart of `calculate_safe_reports_num` for a
+// `chunk_reader`: each report is checked as soon as its line is complete,
+// with one reused buffer instead of a `Jagged` of every report, and takes the
+// scalar dampener path rather than the SIMD blocks.
+[[maybe_unused]] int calculate_safe_reports_num_streaming(helper::chunk_reader& reader) {
+  int count = 0;
+  std::vector<int> report{};
+  reader.for_each_line([&](std::string_view line) {
+    report.clear();
+    helper::number_scanner scanner{line};
+    int level;
+    while (scanner.next(level)) {
+      report.emplace_back(level);
+    }
+    if (!report.empty() && is_report_safe_with_dampener(report)) {
+      ++count;
+    }
   });
+  return count;
 }
 
-int main() {
-  auto reports = parse_input();
-  int safe_reports_num = calculate_safe_reports_num(reports);
+// Only the dampened count (part 2) is solved here.
+[[maybe_unused]] helper::solution solve(std::string_view input) {
+  return {"", std::to_string(calculate_safe_reports_num(parse_input(input)))};
+}
+
+} // namespace
+
+#if defined(AOC_DRIVER)
+helper::register_day const registration{2, solve};
+#else
+int main(int argc, char* argv[]) {
+  // `./main <path>` (`-` for stdin) streams that input instead of solving `input.txt`.
+  if (argc > 1) {
+    helper::chunk_reader reader{argv[1]};
+    std::cout << "How many reports are safe? " << calculate_safe_reports_num_streaming(reader) << std::endl;
+    return 0;
+  }
+
+  helper::mapped_file const file{"input.txt", helper::mapped_file::access_hint::sequential};
+  helper::benchmark bench{};
+
+  auto reports = bench.run("parse_input", [&] { return parse_input(file.view()); });
+  int safe_reports_num = bench.run("calculate_safe_reports_num", [&] {
+    return calculate_safe_reports_num(reports);
+  });
   assert(safe_reports_num == 536);
   std::cout << "How many reports are safe? " << safe_reports_num << std::endl;
+
+  if (bench.run_variants()) {
+    [[maybe_unused]] int streaming_num = bench.run("calculate_safe_reports_num_streaming", [] {
+      helper::chunk_reader reader{"input.txt"};
+      return calculate_safe_reports_num_streaming(reader);
+    });
+    assert(streaming_num == safe_reports_num);
+  }
+
+  bench.report();
 }
+#endif
@@ -3,88 +3,138 @@
 // clang++ -std=gnu++20 -stdlib=libc++ main.cpp -o main && ./main && rm main
 
 #include <string>
-#include <regex>
+#include <string_view>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <optional>
+#include <algorithm>
+#include <bit>
 #include <cassert>
 #include <iostream>
-#include <cctype>
 
 #include "../aoc.h"
 
-[[maybe_unused]] int parse_input_data_with_regex() {
-  std::string input{helper::read_file_as_string("input.txt")};
+namespace {
+
+[[maybe_unused]] int parse_input_data_with_regex(std::string_view input) {
+  using instruction = helper::pattern<R"(mul\((\d{1,3}),(\d{1,3})\)|do\(\)|don't\(\))">;
 
   int res = 0;
-  std::regex pattern{R"(mul\((\d{1,3}),(\d{1,3})\)|do\(\)|don't\(\))"};
-  std::sregex_iterator it{input.cbegin(), input.cend(), pattern};
-  std::sregex_iterator end{};
   bool skip = false;
-  for (; it != end; ++it) {
-    auto const& match = *it;
-    if (match.empty()) {
-      continue;
-    }
+  for (size_t pos = 0; auto const match = instruction::search(input, pos);) {
+    std::string_view const whole = (*match)[0];
+    pos = static_cast<size_t>(whole.data() + whole.size() - input.data());
 
-    if (match[0] == "don't()") {
+    if (whole == "don't()") {
       skip = true;
-    } else if (match[0] == "do()") {
+    } else if (whole == "do()") {
       skip = false;
     } else if (!skip) {
-      res += std::stoi(match[1]) * std::stoi(match[2]);
+      int x = 0;
+      int y = 0;
+      helper::number_scanner{(*match)[1]}.next(x);
+      helper::number_scanner{(*match)[2]}.next(y);
+      res += x * y;
     }
   }
 
   return res;
 }
 
-int parse_input() {
-  std::string input{helper::read_file_as_string("input.txt")};
+// The longest instruction is `mul(123,456)`.
+constexpr size_t max_instruction_len = 12;
 
-  int res = 0;
-  bool skip = false;
-  size_t pos = 0;
-  while (pos < input.size()) {
-    if (skip && (input.size() - pos < 4 || input.compare(pos, 4, "do()") != 0)) {
-      ++pos;
-    } else if (input.compare(pos, 7, "don't()") == 0) {
-      pos += 7;
-      skip = true;
-    } else if (input.compare(pos, 4, "do()") == 0) {
-      pos += 4; // skip `do()`
-      skip = false;
-    } else if (input.compare(pos, 4, "mul(") == 0) {
-      pos += 4; // skip `mul(`
+// Up to three leading digits of `p`, which must have three readable bytes.
+// The digit count is worked out arithmetically rather than digit by digit.
+struct bounded_number {
+  int value;
+  size_t digits;
+};
 
-      int x = 0;
-      int digit_count = 0;
-      while (pos < input.size() && std::isdigit(input[pos]) && digit_count < 3) {
-        x = x * 10 + (input[pos] - '0');
-        ++pos;
-        ++digit_count;
-      }
+bounded_number parse_up_to_3_digits(char const* p) {
+  unsigned const a = static_cast<unsigned char>(p[0] - '0');
+  unsigned const b = static_cast<unsigned char>(p[1] - '0');
+  unsigned const c = static_cast<unsigned char>(p[2] - '0');
+  bool const has_1 = a < 10;
+  bool const has_2 = has_1 && b < 10;
+  bool const has_3 = has_2 && c < 10;
+  int const one = static_cast<int>(a);
+  int const two = one * 10 + static_cast<int>(b);
+  int const three = two * 10 + static_cast<int>(c);
+  return {has_3 ? three : has_2 ? two : has_1 ? one : 0, size_t{has_1} + has_2 + has_3};
+}
 
-      if (digit_count == 0 || pos >= input.size() || input[pos] != ',') {
-        continue;
-      }
+// Length of the `mul(X,Y)` instruction at the start of `text`, with X and Y
+// 1-3 digits each, storing X * Y in `product`; 0 if there is none.
+size_t match_mul(std::string_view text, int& product) {
+  // Near the end of the input, a zero-padded copy keeps every read in bounds.
+  char padded[max_instruction_len]{};
+  char const* p = text.data();
+  if (text.size() < max_instruction_len) {
+    std::memcpy(padded, text.data(), text.size());
+    p = padded;
+  }
 
-      ++pos; // skip `,`
+  if (std::memcmp(p, "mul(", 4) != 0) { return 0; }
+  auto const [x, x_digits] = parse_up_to_3_digits(p + 4);
+  size_t const comma = 4 + x_digits;
+  if (x_digits == 0 || p[comma] != ',') { return 0; }
+  auto const [y, y_digits] = parse_up_to_3_digits(p + comma + 1);
+  size_t const close = comma + 1 + y_digits;
+  if (y_digits == 0 || p[close] != ')') { return 0; }
 
-      int y = 0;
-      digit_count = 0;
-      while (pos < input.size() && std::isdigit(input[pos]) && digit_count < 3) {
-        y = y * 10 + (input[pos] - '0');
-        ++pos;
-        ++digit_count;
-      }
-
-      if (digit_count == 0 || pos >= input.size() || input[pos] != ')') {
-        continue;
-      }
-
-      ++pos; // skip `)`
-
-      if (!skip) {
-        res += x * y;
-      }
+  product = x * y;
+  return close + 1;
+}
+
+// Where the next instruction could start in [pos, limit): a `do`, or, unless
+// `skip`, a `mu`; `limit` if there is none. Whole 32-byte blocks are checked
+// with vector compares, so long runs of noise (or of a disabled region, where
+// only `do()` matters) are passed over without looking at single bytes.
+size_t find_candidate(std::string_view input, size_t pos, size_t limit, bool skip) {
+  using helper::simd::block_size;
+  using helper::simd::byte_mask;
+
+  char const* data = input.data();
+  for (; pos < limit && pos + block_size < input.size(); pos += block_size) {
+    uint32_t mask = byte_mask(data + pos, 'd') & byte_mask(data + pos + 1, 'o');
+    if (!skip) {
+      mask |= byte_mask(data + pos, 'm') & byte_mask(data + pos + 1, 'u');
+    }
+    if (mask != 0) {
+      return std::min(limit, pos + std::countr_zero(mask));
+    }
+  }
+
+  for (; pos < limit && pos + 1 < input.size(); ++pos) {
+    if ((data[pos] == 'd' && data[pos + 1] == 'o') || (!skip && data[pos] == 'm' && data[pos + 1] == 'u')) {
+      return pos;
+    }
+  }
+  return limit;
+}
+
+// Adds up the enabled multiplications among the instructions starting in
+// [pos, limit), resuming in state `skip`. Both `pos` and `skip` are left where
+// the scan ended, so it can be continued later (e.g. on the next block of a
+// stream). Instructions may extend past `limit`, but not past `input`.
+int64_t sum_multiplications(std::string_view input, size_t& pos, size_t limit, bool& skip) {
+  int64_t res = 0;
+  while ((pos = find_candidate(input, pos, limit, skip)) < limit) {
+    std::string_view const rest = input.substr(pos);
+    int product = 0;
+    if (rest.starts_with("do()")) {
+      pos += 4;
+      skip = false;
+    } else if (skip) {
+      ++pos;
+    } else if (rest.starts_with("don't()")) {
+      pos += 7;
+      skip = true;
+    } else if (size_t const len = match_mul(rest, product); len != 0) {
+      pos += len;
+      res += product;
     } else {
       ++pos;
     }
@@ -93,8 +143,144 @@ int parse_input() {
   return res;
 }
 
-int main() {
-  int res = parse_input();
+[[maybe_unused]] int64_t parse_input(std::string_view input) {
+  bool skip = false;
+  size_t pos = 0;
+  return sum_multiplications(input, pos, input.size(), skip);
+}
+
+// Position of the first `do()` or `don't()` starting in [pos, limit), or
+// `limit` if there is none.
+size_t find_toggle(std::string_view input, size_t pos, size_t limit) {
+  while ((pos = find_candidate(input, pos, limit, true)) < limit) {
+    std::string_view const rest = input.substr(pos);
+    if (rest.starts_with("do()") || rest.starts_with("don't()")) {
+      return pos;
+    }
+    ++pos;
+  }
+  return limit;
+}
+
+// What the instructions starting in one chunk of the input add up to, for
+// either state the scan may be in when it reaches the chunk.
+struct chunk_summary {
+  int64_t sum_if_enabled = 0;
+  int64_t sum_if_disabled = 0;
+  // The state after the chunk's last `do()`/`don't()`; empty if it has none
+  // and passes the incoming state through.
+  std::optional<bool> final_skip{};
+};
+
+// Both starting states agree from the chunk's first `do()`/`don't()` on, so
+// the chunk is scanned once: the multiplications before that toggle count
+// only if the chunk starts enabled.
+chunk_summary summarize_chunk(std::string_view input, size_t begin, size_t end) {
+  size_t const toggle = find_toggle(input, begin, end);
+  size_t pos = begin;
+  bool skip = false;
+  int64_t const before_toggle = sum_multiplications(input, pos, toggle, skip);
+  if (toggle == end) {
+    return {before_toggle, 0, std::nullopt};
+  }
+
+  pos = toggle;
+  int64_t const from_toggle = sum_multiplications(input, pos, end, skip);
+  return {before_toggle + from_toggle, from_toggle, skip};
+}
+
+// Splits the input into chunks that are summarized in parallel, then folds
+// the summaries in order, carrying the state from chunk to chunk. An
+// instruction belongs to the chunk it starts in; chunks read up to
+// `max_instruction_len - 1` bytes past their end to finish one. Instructions
+// never overlap, so the chunks see exactly the instructions a single scan
+// would.
+int64_t sum_multiplications_parallel(std::string_view input) {
+  constexpr size_t min_chunk_size = size_t{1} << 16;
+
+  auto& pool = helper::thread_pool::global();
+  size_t const chunks =
+    std::clamp<size_t>(input.size() / min_chunk_size, 1, size_t{pool.size()} * 4);
+  size_t const chunk_size = (input.size() + chunks - 1) / chunks;
+
+  std::vector<chunk_summary> summaries(chunks);
+  pool.parallel_for(0, chunks, [&](size_t chunk) {
+    size_t const begin = std::min(input.size(), chunk * chunk_size);
+    size_t const end = std::min(input.size(), begin + chunk_size);
+    summaries[chunk] = summarize_chunk(input, begin, end);
+  }, 1);
+
+  int64_t res = 0;
+  bool skip = false;
+  for (auto const& summary : summaries) {
+    res += skip ? summary.sum_if_disabled : summary.sum_if_enabled;
+    skip = summary.final_skip.value_or(skip);
+  }
+  return res;
+}
+
+// `sum_multiplications` over a `chunk_reader`, block by block. The scan stops
+// `max_instruction_len - 1` bytes short of a block's end, so an instruction
+// cut by the block boundary is carried over and matched whole in the next
+// block; the enabled state carries over with it.
+[[maybe_unused]] int64_t sum_multiplications_streaming(helper::chunk_reader& reader) {
+  int64_t res = 0;
+  bool skip = false;
+  reader.read([&](std::string_view data, bool is_last) {
+    // An instruction starting this close to the end of a block may continue in
+    // the next one, so it is left for then.
+    size_t limit = is_last ? data.size() : data.size() - std::min(data.size(), max_instruction_len - 1);
+    size_t pos = 0;
+    res += sum_multiplications(data, pos, limit, skip);
+    return pos;
+  });
+  return res;
+}
+
+// Only the sum with `do()`/`don't()` honored (part 2) is solved here.
+[[maybe_unused]] helper::solution solve(std::string_view input) {
+  return {"", std::to_string(sum_multiplications_parallel(input))};
+}
+
+} // namespace
+
+#if defined(AOC_DRIVER)
+helper::register_day const registration{3, solve};
+#else
+int main(int argc, char* argv[]) {
+  // `./main <path>` (`-` for stdin) streams that input instead of solving `input.txt`.
+  if (argc > 1) {
+    helper::chunk_reader reader{argv[1]};
+    std::cout << "What do you get if you add up all of the results of the multiplications? "
+              << sum_multiplications_streaming(reader) << std::endl;
+    return 0;
+  }
+
+  helper::mapped_file const file{"input.txt", helper::mapped_file::access_hint::sequential};
+  helper::benchmark bench{};
+
+  int64_t res = bench.run("parse_input", [&] { return parse_input(file.view()); });
   assert(res == 75920122);
   std::cout << "What do you get if you add up all of the results of the multiplications? " << res << std::endl;
+
+  if (bench.run_variants()) {
+    [[maybe_unused]] int regex_res = bench.run("parse_input_data_with_regex", [&] {
+      return parse_input_data_with_regex(file.view());
+    });
+    assert(regex_res == res);
+
+    [[maybe_unused]] int64_t streaming_res = bench.run("sum_multiplications_streaming", [] {
+      helper::chunk_reader reader{"input.txt"};
+      return sum_multiplications_streaming(reader);
+    });
+    assert(streaming_res == res);
+
+    [[maybe_unused]] int64_t parallel_res = bench.run("sum_multiplications_parallel", [&] {
+      return sum_multiplications_parallel(file.view());
+    });
+    assert(parallel_res == res);
+  }
+
+  bench.report();
 }
+#endif
@@ -3,112 +3,179 @@
 // clang++ -std=gnu++20 -stdlib=libc++ main.cpp -o main && ./main && rm main
 
 #include <string>
-#include <sstream>
-#include <vector>
+#include <string_view>
 #include <array>
+#include <vector>
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <functional>
 #include <cassert>
 #include <iostream>
 
 #include "../aoc.h"
 
-std::vector<std::string> parse_input() {
-  std::ifstream ifs{helper::read_file_as_stream("input.txt")};
-
-  std::vector<std::string> result{};
-  std::string line{};
-  while (std::getline(ifs, line)) {
-    result.push_back(std::move(line));
-  }
-
-  return result;
-}
-
-bool is_xmas_start_at(std::vector<std::string> const& board,
-                      std::string const& xmas,
-                      int start_row, int start_col,
-                      int dir_row, int dir_col) {
-  int rows = board.size();
-  int cols = board[0].size();
-  for (int i = 1; i < xmas.length(); ++i) {
-    int row = start_row + dir_row * i;
-    int col = start_col + dir_col * i;
-    if (row < 0 || row >= rows || col < 0 || col >= cols || board[row][col] != xmas[i]) {
-      return false;
+namespace {
+
+// One bit plane per letter of "XMAS": `planes[i]` has the cells holding
+// "XMAS"[i]. Every other letter is in no plane.
+using letter_planes = std::array<helper::BitGrid, 4>;
+
+// Full words of a row are classified 32 bytes at a time with vector
+// compares; only the last, partial word goes cell by cell.
+letter_planes parse_input(std::string_view input) {
+  constexpr std::string_view xmas{"XMAS"};
+
+  std::string_view text = input;
+  int const cols = static_cast<int>(helper::pop_line(text).size());
+  int const rows = static_cast<int>(std::count(input.begin(), input.end(), '\n')) + (input.ends_with('\n') ? 0 : 1);
+
+  letter_planes planes{};
+  planes.fill(helper::BitGrid{rows, cols});
+  text = input;
+  for (int row = 0; row < rows; ++row) {
+    std::string_view const line = helper::pop_line(text);
+    int const width = std::min(cols, static_cast<int>(line.size()));
+    int col = 0;
+    for (; col + 64 <= width; col += 64) {
+      for (std::size_t letter = 0; letter < xmas.size(); ++letter) {
+        uint64_t const low = helper::simd::byte_mask(line.data() + col, xmas[letter]);
+        uint64_t const high = helper::simd::byte_mask(line.data() + col + 32, xmas[letter]);
+        planes[letter].set_word(row, col / 64, low | (high << 32));
+      }
+    }
+    for (; col < width; ++col) {
+      if (auto const letter = xmas.find(line[col]); letter != std::string_view::npos) {
+        planes[letter].set(row, col);
+      }
     }
   }
 
-  return true;
+  return planes;
 }
 
-int search_xmas(std::vector<std::string> const& board) {
-  constexpr std::array<std::pair<int, int>, 8> directions{{
-    {-1, 0}, // N
-    {-1, 1}, // NE
-    {0, 1},  // E
-    {1, 1},  // SE
-    {1, 0},  // S
-    {1, -1}, // SW
-    {0, -1}, // W
-    {-1, -1} // NW
-  }};
-
-  int count = 0;
-  int rows = board.size();
-  int cols = board[0].size();
-  for (int i = 0; i < rows; ++i) {
-    for (int j = 0; j < cols; ++j) {
-      if (board[i][j] != 'X') {
-        continue;
-      }
-
-      for (auto const& [dir_row, dir_col] : directions) {
-        if (is_xmas_start_at(board, "XMAS", i, j, dir_row, dir_col)) {
-          ++count;
+// For each of the 8 directions, letter `i` of "XMAS" must sit `i` steps
+// along it from the X. Shifting each plane's words by `i` steps lines those
+// cells up with the X, so one AND per word tests 64 starting cells at once.
+//
+// Matches are counted at the row of their X, in row bands on the pool. A band
+// reads up to 3 rows past either edge straight from the shared planes, so it
+// carries no state across its edges and needs no halo.
+int64_t search_xmas(letter_planes const& planes) {
+  auto const& [x, m, a, s] = planes;
+  int const rows = x.rows();
+  int const words = x.words();
+
+  return helper::reduce_row_bands(rows, 0, int64_t{0}, [&](int, int begin, int end) {
+    int64_t count = 0;
+    for (int drow = -1; drow <= 1; ++drow) {
+      for (int dcol = -1; dcol <= 1; ++dcol) {
+        if (drow == 0 && dcol == 0) { continue; }
+
+        int const first_row = std::max(begin, -3 * drow);
+        int const last_row = std::min(end, rows - std::max(0, 3 * drow));
+        for (int row = first_row; row < last_row; ++row) {
+          for (int w = 0; w < words; ++w) {
+            uint64_t const hits = x.word(row, w)
+                                & m.word(row + drow, w, dcol)
+                                & a.word(row + 2 * drow, w, 2 * dcol)
+                                & s.word(row + 3 * drow, w, 3 * dcol);
+            count += std::popcount(hits);
+          }
         }
       }
-    } // j
-  } // i
-
-  return count;
+    }
+    return count;
+  }, std::plus<int64_t>{});
 }
 
-int search_x_mas(std::vector<std::string> const& board) {
-  int count = 0;
-
-  int rows = board.size();
-  int cols = board[0].size();
-  std::string candidate(3, 'A');
-  for (int i = 1; i < rows - 1; ++i) {
-    for (int j = 1; j < cols - 1; ++j) {
-      if (board[i][j] != 'A') {
-        continue;
+// An A is the center of an X-MAS if each diagonal through it has an M at one
+// end and an S at the other, tested for 64 A cells at once like `search_xmas`
+// and banded the same way.
+int64_t search_x_mas(letter_planes const& planes) {
+  auto const& [x, m, a, s] = planes;
+  int const rows = a.rows();
+  int const words = a.words();
+
+  return helper::reduce_row_bands(rows, 0, int64_t{0}, [&](int, int begin, int end) {
+    int64_t count = 0;
+    for (int row = std::max(begin, 1); row < std::min(end, rows - 1); ++row) {
+      for (int w = 0; w < words; ++w) {
+        uint64_t const down_right = (m.word(row - 1, w, -1) & s.word(row + 1, w, 1))
+                                  | (s.word(row - 1, w, -1) & m.word(row + 1, w, 1));
+        uint64_t const down_left = (m.word(row - 1, w, 1) & s.word(row + 1, w, -1))
+                                 | (s.word(row - 1, w, 1) & m.word(row + 1, w, -1));
+        count += std::popcount(a.word(row, w) & down_right & down_left);
       }
+    }
+    return count;
+  }, std::plus<int64_t>{});
+}
 
-      candidate[0] = board[i - 1][j - 1];
-      candidate[2] = board[i + 1][j + 1];
-      if (candidate != "MAS" && candidate != "SAM") {
-        continue;
-      }
+std::vector<std::string_view> split_rows(std::string_view input) {
+  std::vector<std::string_view> rows{};
+  while (!input.empty()) { rows.emplace_back(helper::pop_line(input)); }
+  return rows;
+}
 
-      candidate[0] = board[i - 1][j + 1];
-      candidate[2] = board[i + 1][j - 1];
-      if (candidate == "MAS" || candidate == "SAM") {
-        ++count;
-      }
-    }
-  }
+// Same count through the general dictionary search, as a check on it.
+[[maybe_unused]] int64_t search_xmas_with_word_search(std::string_view input) {
+  constexpr std::array<std::string_view, 1> words{"XMAS"};
+  return helper::word_search{words}.count(split_rows(input))[0];
+}
 
+// Every diagonal "MAS" marks its middle cell; an X-MAS is an A marked by
+// both diagonals, i.e. by two of the matches.
+[[maybe_unused]] int64_t search_x_mas_with_word_search(std::string_view input) {
+  constexpr std::array<std::string_view, 1> words{"MAS"};
+  auto const rows = split_rows(input);
+  int const cols = rows.empty() ? 0 : static_cast<int>(rows[0].size());
+
+  std::vector<uint8_t> marks(rows.size() * cols);
+  int64_t count = 0;
+  helper::word_search{words}.for_each_match(rows, [&](helper::word_search::match const& m) {
+    if (m.drow != 0 && m.dcol != 0) {
+      count += ++marks[static_cast<std::size_t>(m.row + m.drow) * cols + m.col + m.dcol] == 2;
+    }
+  });
   return count;
 }
 
+[[maybe_unused]] helper::solution solve(std::string_view input) {
+  auto board = parse_input(input);
+  return {std::to_string(search_xmas(board)), std::to_string(search_x_mas(board))};
+}
+
+} // namespace
+
+#if defined(AOC_DRIVER)
+helper::register_day const registration{4, solve};
+#else
 int main() {
-  auto board = parse_input();
-  int res = search_xmas(board);
+  helper::mapped_file const file{"input.txt", helper::mapped_file::access_hint::sequential};
+  helper::benchmark bench{};
+
+  auto board = bench.run("parse_input", [&] { return parse_input(file.view()); });
+  int64_t res = bench.run("search_xmas", [&] { return search_xmas(board); });
   assert(res == 2297);
   std::cout << "How many times does XMAS appear? " << res << std::endl;
 
-  res = search_x_mas(board);
+  res = bench.run("search_x_mas", [&] { return search_x_mas(board); });
   assert(res == 1745);
   std::cout << "How many times does an X-MAS appear? " << res << std::endl;
-}
 
+  if (bench.run_variants()) {
+    [[maybe_unused]] int64_t word_search_xmas = bench.run("search_xmas_with_word_search", [&] {
+      return search_xmas_with_word_search(file.view());
+    });
+    assert(word_search_xmas == 2297);
+
+    [[maybe_unused]] int64_t word_search_x_mas = bench.run("search_x_mas_with_word_search", [&] {
+      return search_x_mas_with_word_search(file.view());
+    });
+    assert(word_search_x_mas == res);
+  }
+
+  bench.report();
+}
+#endif
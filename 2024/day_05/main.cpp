@@ -2,77 +2,178 @@
 //
 // clang++ -std=gnu++20 -stdlib=libc++ main.cpp -o main && ./main && rm main
 
-#include <sstream>
+#include <string>
+#include <string_view>
 #include <vector>
-#include <unordered_map>
-#include <unordered_set>
+#include <span>
 #include <utility>
 #include <algorithm>
 #include <iterator>
+#include <numeric>
 #include <cassert>
 #include <iostream>
 
 #include "../aoc.h"
 
-auto parse_input() {
-  std::ifstream ifs{helper::read_file_as_stream("input.txt")};
+namespace {
 
-  std::unordered_map<int, std::unordered_set<int>> rules{};
-  std::string line{};
-  while (std::getline(ifs, line) && !line.empty()) {
-    size_t pos = line.find('|');
-    int first = std::stoi(line.substr(0, pos));
-    int second = std::stoi(line.substr(pos + 1));
-    rules[first].emplace(second);
+// `precedes(lhs, rhs)` if a rule says page `lhs` must come before page
+// `rhs`. Page numbers are small, so the rules are a dense bit matrix indexed
+// by page, sized to the largest page in the rules or the updates; every
+// comparison is a single bit test.
+class ordering_rules {
+public:
+  ordering_rules() = default;
+  explicit ordering_rules(int pages) : before_{pages, pages} {}
+
+  void add(int lhs, int rhs) noexcept { before_.set(lhs, rhs); }
+  bool precedes(int lhs, int rhs) const noexcept { return before_.test(lhs, rhs); }
+
+private:
+  helper::BitGrid before_{};
+};
+
+auto parse_input(std::string_view input) {
+  // The rules and the updates are separated by a blank line.
+  std::size_t const blank_line = input.find("\n\n");
+  std::string_view const rules_section = input.substr(0, blank_line);
+  std::string_view const updates_section =
+    blank_line == std::string_view::npos ? std::string_view{} : input.substr(blank_line + 2);
+
+  // The matrix is sized once every page number has been seen.
+  int max_page = 0;
+  std::vector<std::pair<int, int>> rule_pairs{};
+  helper::number_scanner rules_scanner{rules_section};
+  int first, second;
+  while (rules_scanner.next(first) && rules_scanner.next(second)) {
+    rule_pairs.emplace_back(first, second);
+    max_page = std::max({max_page, first, second});
   }
 
-  std::vector<std::vector<int>> updates{};
-  while (std::getline(ifs, line)) {
-    std::istringstream line_iss{line};
-    std::vector<int> update{};
-    std::string page{};
-    while (std::getline(line_iss, page, ',')) {
-      update.emplace_back(std::stoi(page));
-    }
-    if (!update.empty()) {
-      updates.emplace_back(std::move(update));
+  helper::Jagged<int> updates{};
+  helper::number_scanner updates_scanner{updates_section};
+  int page;
+  while (updates_scanner.next(page)) {
+    if (updates.empty() || updates_scanner.newline_before()) {
+      updates.start_row();
     }
+    updates.push_back(page);
+    max_page = std::max(max_page, page);
   }
 
-  return std::pair{rules, updates};
+  ordering_rules rules{max_page + 1};
+  for (auto [lhs, rhs] : rule_pairs) {
+    rules.add(lhs, rhs);
+  }
+
+  return std::pair{std::move(rules), std::move(updates)};
 }
 
-bool is_correct_update(std::vector<int> const& update,
-                       std::unordered_map<int, std::unordered_set<int>> const& rules) {
-  return std::is_sorted(update.begin(), update.end(), [&rules](int lhs, int rhs) {
-    return rules.contains(lhs) && rules.at(lhs).contains(rhs);
-  });
+// Ordered if no page must come before the one ahead of it. Every adjacent
+// pair is tested, without an early exit, so the loop has no data-dependent
+// branch.
+bool is_correct_update(std::span<int const> update, ordering_rules const& rules) {
+  bool out_of_order = false;
+  for (std::size_t i = 1; i < update.size(); ++i) {
+    out_of_order |= rules.precedes(update[i], update[i - 1]);
+  }
+  return !out_of_order;
 }
 
-void sort_update(std::vector<int>& update,
-                 std::unordered_map<int, std::unordered_set<int>> const& rules) {
+void sort_update(std::span<int> update, ordering_rules const& rules) {
   std::sort(update.begin(), update.end(), [&rules](int lhs, int rhs) {
-    return rules.contains(lhs) && rules.at(lhs).contains(rhs);
+    return rules.precedes(lhs, rhs);
   });
 }
 
-int add_up_middle_page_nums(std::vector<int> mid_pages) {
-  return std::reduce(mid_pages.cbegin(), mid_pages.cend());
+// The page that exactly `size / 2` other pages of the update must come
+// before, i.e. where sorting would put it, found by counting with one bit
+// test per pair of pages instead of reordering anything. Rules that don't
+// order the whole update may leave no such page; a sorted copy decides then.
+int middle_page(std::span<int const> update, ordering_rules const& rules) {
+  std::size_t const half = update.size() / 2;
+  for (int page : update) {
+    std::size_t ahead = 0;
+    for (int other : update) {
+      ahead += rules.precedes(other, page);
+    }
+    if (ahead == half) { return page; }
+  }
+
+  std::vector<int> sorted(update.begin(), update.end());
+  sort_update(sorted, rules);
+  return sorted[half];
 }
 
-int main() {
-  auto [rules, updates] = parse_input();
+using middle_pages = std::pair<std::vector<int>, std::vector<int>>;
+
+// Middle pages of the correctly-ordered updates, then of the incorrect ones
+// once ordered, both in input order. Updates are independent, so batches of
+// them are checked in parallel and the batch results appended in order.
+middle_pages collect_middle_pages(helper::Jagged<int> const& updates, ordering_rules const& rules) {
+  constexpr std::size_t batch_size = 1024;
 
-  std::vector<int> part1_mid_pages{};
-  std::vector<int> part2_mid_pages{};
-  for (auto& update : updates) {
+  std::size_t const batches = (updates.size() + batch_size - 1) / batch_size;
+  return helper::thread_pool::global().parallel_reduce(0, batches, middle_pages{}, [&](std::size_t batch) {
+    middle_pages res{};
+    std::size_t const end = std::min(updates.size(), (batch + 1) * batch_size);
+    for (std::size_t i = batch * batch_size; i < end; ++i) {
+      auto const update = updates[i];
+      if (is_correct_update(update, rules)) {
+        res.first.emplace_back(update[update.size() / 2]);
+      } else {
+        res.second.emplace_back(middle_page(update, rules));
+      }
+    }
+    return res;
+  }, [](middle_pages acc, middle_pages batch) {
+    acc.first.insert(acc.first.end(), batch.first.begin(), batch.first.end());
+    acc.second.insert(acc.second.end(), batch.second.begin(), batch.second.end());
+    return acc;
+  }, 1);
+}
+
+// Serial variant that sorts every incorrect update in place to read its
+// middle page, so `updates` is taken by value.
+[[maybe_unused]] middle_pages collect_middle_pages_by_sorting(helper::Jagged<int> updates, ordering_rules const& rules) {
+  middle_pages res{};
+  for (std::size_t i = 0; i < updates.size(); ++i) {
+    auto update = updates[i];
     if (is_correct_update(update, rules)) {
-      part1_mid_pages.emplace_back(update[update.size() / 2]);
+      res.first.emplace_back(update[update.size() / 2]);
     } else {
       sort_update(update, rules);
-      part2_mid_pages.emplace_back(update[update.size() / 2]);
+      res.second.emplace_back(update[update.size() / 2]);
     }
   }
+  return res;
+}
+
+int add_up_middle_page_nums(std::vector<int> mid_pages) {
+  return std::reduce(mid_pages.cbegin(), mid_pages.cend());
+}
+
+[[maybe_unused]] helper::solution solve(std::string_view input) {
+  auto [rules, updates] = parse_input(input);
+  auto [part1_mid_pages, part2_mid_pages] = collect_middle_pages(updates, rules);
+  return {std::to_string(add_up_middle_page_nums(part1_mid_pages)),
+          std::to_string(add_up_middle_page_nums(part2_mid_pages))};
+}
+
+} // namespace
+
+#if defined(AOC_DRIVER)
+helper::register_day const registration{5, solve};
+#else
+int main() {
+  helper::mapped_file const file{"input.txt", helper::mapped_file::access_hint::sequential};
+  helper::benchmark bench{};
+
+  auto [rules, updates] = bench.run("parse_input", [&] { return parse_input(file.view()); });
+
+  auto [part1_mid_pages, part2_mid_pages] = bench.run("collect_middle_pages", [&] {
+    return collect_middle_pages(updates, rules);
+  });
 
   int part1_sum = add_up_middle_page_nums(part1_mid_pages);
   assert(part1_sum == 4569);
@@ -81,4 +182,14 @@ int main() {
   int part2_sum = add_up_middle_page_nums(part2_mid_pages);
   assert(part2_sum == 6456);
   std::cout << "What do you get if you add up the middle page numbers after correctly ordering just those updates? " << part2_sum << '\n';
+
+  if (bench.run_variants()) {
+    [[maybe_unused]] auto sorted_mid_pages = bench.run("collect_middle_pages_by_sorting", [&] {
+      return collect_middle_pages_by_sorting(updates, rules);
+    });
+    assert(sorted_mid_pages == std::pair(part1_mid_pages, part2_mid_pages));
+  }
+
+  bench.report();
 }
+#endif
@@ -2,50 +2,42 @@
 //
 // clang++ -std=gnu++20 -stdlib=libc++ main.cpp -o main && ./main && rm main
 
-#include <vector>
 #include <string>
-#include <fstream>
+#include <string_view>
+#include <vector>
 #include <utility>
 #include <algorithm>
 #include <iterator>
 #include <array>
 #include <memory>
 #include <cstring>
+#include <stdexcept>
 #include <cassert>
 #include <iostream>
 
 #include "../aoc.h"
 
-constexpr std::array<std::pair<int, int>, 4> directions{{
-  {-1, 0}, // up
-  {0, 1},  // right
-  {1, 0},  // down
-  {0, -1}  // left
-}};
+namespace {
 
-std::vector<std::string> parse_input() {
-  std::ifstream ifs{helper::read_file_as_stream("input.txt")};
-
-  std::vector<std::string> map{};
-  std::string row{};
-  while (std::getline(ifs, row)) {
-    map.emplace_back(std::move(row));
-  }
+// The map is framed by a one-cell border of this value, so the guard leaves
+// the mapped area exactly when it steps onto it.
+constexpr char off_map = '\0';
 
-  return map;
+helper::Grid<char> parse_input(std::string_view input) {
+  return helper::Grid<char>::parse(input, 1, off_map);
 }
 
-std::pair<std::pair<int, int>, int> find_initial_position_and_direction(std::vector<std::string>& map) {
+std::pair<int, int> find_initial_position_and_direction(helper::Grid<char>& map) {
   constexpr std::array<char, 4> indicators{'^', '>', 'v', '<'};
 
-  int const rows = map.size();
-  int const cols = map[0].size();
+  int const rows = map.rows();
+  int const cols = map.cols();
   for (int i = 0; i < rows; ++i) {
     for (int j = 0; j < cols; ++j) {
-      auto it = std::find(indicators.cbegin(), indicators.cend(), map[i][j]);
+      auto it = std::find(indicators.cbegin(), indicators.cend(), map(i, j));
       if (it != indicators.cend()) {
-        map[i][j] = '.';
-        return {{i, j}, std::distance(indicators.cbegin(), it)};
+        map(i, j) = '.';
+        return {map.index(i, j), std::distance(indicators.cbegin(), it)};
       }
     }
   }
@@ -53,104 +45,119 @@ std::pair<std::pair<int, int>, int> find_initial_position_and_direction(std::vec
   throw std::runtime_error{"Cannot find initial position indicator (^)"};
 }
 
-auto compute_guard_exit_path(std::vector<std::string> const& map, std::pair<int, int> const& start_pos, int const start_dir) {
-  int const rows = map.size();
-  int const cols = map[0].size();
+// Positions are linear indices into `map`, and directions index into
+// `map.neighbor_offsets4()` (up, right, down, left).
+std::vector<int> compute_guard_exit_path(helper::Grid<char> const& map, int const start_pos, int const start_dir) {
+  auto const directions = map.neighbor_offsets4();
 
-  int row = start_pos.first;
-  int col = start_pos.second;
+  int pos = start_pos;
   int dir = start_dir;
 
-  std::vector<std::pair<int, int>> exit_path{start_pos};
-  std::vector<bool> visited(rows * cols, false);
-  visited[cols * row + col] = true;
+  std::vector<int> exit_path{start_pos};
+  std::vector<bool> visited(map.buffer_size(), false);
+  visited[pos] = true;
 
   while (true) {
-    int next_row = row + directions[dir].first;
-    int next_col = col + directions[dir].second;
-    if (next_row < 0 || next_row >= rows || next_col < 0 || next_col >= cols) {
+    int next_pos = pos + directions[dir];
+    if (map[next_pos] == off_map) {
       break;
     }
 
-    if (map[next_row][next_col] == '#') {
+    if (map[next_pos] == '#') {
       dir = (dir + 1) % directions.size();
     } else {
-      if (!visited[next_row * cols + next_col]) {
-        exit_path.emplace_back(next_row, next_col);
-        visited[next_row * cols + next_col] = true;
+      if (!visited[next_pos]) {
+        exit_path.emplace_back(next_pos);
+        visited[next_pos] = true;
       }
 
-      row = next_row;
-      col = next_col;
+      pos = next_pos;
     }
   }
 
   return exit_path;
 }
 
-bool will_guard_loop(std::vector<std::string> const& map, std::pair<int, int> const& start_pos, int const start_dir, bool* visited, int const visited_size) {
+// `obstruction` is treated as one more `#`, so candidates can be tried
+// concurrently against the same, unmodified map.
+bool will_guard_loop(helper::Grid<char> const& map, int const obstruction, int const start_pos, int const start_dir,
+                     bool* visited, int const visited_size) {
+  AOC_ZONE("will_guard_loop");
   std::memset(visited, 0, sizeof(bool) * visited_size);
 
-  int const rows = map.size();
-  int const cols = map[0].size();
+  auto const directions = map.neighbor_offsets4();
 
-  int row = start_pos.first;
-  int col = start_pos.second;
+  int pos = start_pos;
   int dir = start_dir;
 
   while (true) {
-    int hash = (cols * row + col) * directions.size() + dir;
+    AOC_COUNT("will_guard_loop.steps");
+    int hash = pos * directions.size() + dir;
     if (visited[hash]) {
       return true;
     }
     visited[hash] = true;
 
-    int next_row = row + directions[dir].first;
-    int next_col = col + directions[dir].second;
-    if (next_row < 0 || next_row >= rows || next_col < 0 || next_col >= cols) {
+    int next_pos = pos + directions[dir];
+    if (map[next_pos] == off_map) {
       return false;
     }
 
-    if (map[next_row][next_col] == '#') {
+    if (map[next_pos] == '#' || next_pos == obstruction) {
       dir = (dir + 1) % directions.size();
     } else {
-      row = next_row;
-      col = next_col;
+      pos = next_pos;
     }
   }
 }
 
-int find_possible_obstructions(std::vector<std::string>& map, std::pair<int, int> const& start_pos, int const start_dir, std::vector<std::pair<int, int>> const& guard_exit_path) {
-  int const rows = map.size();
-  int const cols = map[0].size();
+// Candidates are tried in parallel, each thread reusing its own `visited`.
+int find_possible_obstructions(helper::Grid<char> const& map, int const start_pos, int const start_dir, std::vector<int> const& guard_exit_path) {
+  int const size = map.buffer_size() * 4;
+  helper::per_thread<std::unique_ptr<bool[]>> visited{};
 
-  int const size = rows * cols * directions.size();
-  std::unique_ptr<bool[]> visited(new bool[size]{});
+  return helper::thread_pool::global().parallel_reduce(0, guard_exit_path.size(), 0, [&](std::size_t i) {
+    int const pos = guard_exit_path[i];
+    if (pos == start_pos || map[pos] == '#') { return 0; }
 
-  int result = 0;
-  for (auto const &pos : guard_exit_path) {
-    if (pos != start_pos && map[pos.first][pos.second] != '#') {
-      char backup = map[pos.first][pos.second];
-      map[pos.first][pos.second] = '#';
-      if (will_guard_loop(map, start_pos, start_dir, visited.get(), size)) {
-        ++result;
-      }
-      map[pos.first][pos.second] = backup;
-    }
-  }
+    auto& local_visited = visited.local();
+    if (!local_visited) { local_visited.reset(new bool[size]{}); }
+    return will_guard_loop(map, pos, start_pos, start_dir, local_visited.get(), size) ? 1 : 0;
+  }, std::plus<int>{});
+}
 
-  return result;
+[[maybe_unused]] helper::solution solve(std::string_view input) {
+  auto map = parse_input(input);
+  auto [start_pos, start_dir] = find_initial_position_and_direction(map);
+  auto exit_path = compute_guard_exit_path(map, start_pos, start_dir);
+  int obstructions_cnt = find_possible_obstructions(map, start_pos, start_dir, exit_path);
+  return {std::to_string(exit_path.size()), std::to_string(obstructions_cnt)};
 }
 
+} // namespace
+
+#if defined(AOC_DRIVER)
+helper::register_day const registration{6, solve};
+#else
 int main() {
-  auto map = parse_input();
+  helper::mapped_file const file{"input.txt", helper::mapped_file::access_hint::sequential};
+  helper::benchmark bench{};
+
+  auto map = bench.run("parse_input", [&] { return parse_input(file.view()); });
 
   auto [start_pos, start_dir] = find_initial_position_and_direction(map);
-  auto exit_path = compute_guard_exit_path(map, start_pos, start_dir);
+  auto exit_path = bench.run("compute_guard_exit_path", [&] {
+    return compute_guard_exit_path(map, start_pos, start_dir);
+  });
   assert(exit_path.size() == 5409);
   std::cout << "How many distinct positions will the guard visit before leaving the mapped area? " << exit_path.size() << '\n';
 
-  int obstructions_cnt = find_possible_obstructions(map, start_pos, start_dir, exit_path);
+  int obstructions_cnt = bench.run("find_possible_obstructions", [&] {
+    return find_possible_obstructions(map, start_pos, start_dir, exit_path);
+  });
   assert(obstructions_cnt == 2022);
   std::cout << "How many different positions could you choose for this obstruction? " << obstructions_cnt << '\n';
+
+  bench.report();
 }
+#endif
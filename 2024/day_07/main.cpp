@@ -3,9 +3,10 @@
 // clang++ -std=gnu++20 -stdlib=libc++ main.cpp -o main && ./main && rm main
 
 #include <cstdint>
-#include <fstream>
-#include <sstream>
+#include <string>
+#include <string_view>
 #include <vector>
+#include <span>
 #include <utility>
 #include <functional>
 #include <cassert>
@@ -14,28 +15,31 @@
 
 #include "../aoc.h"
 
+namespace {
+
 using u64 = uint64_t;
 
-std::vector<std::pair<u64, std::vector<u64>>> parse_input() {
-  std::ifstream ifs{helper::read_file_as_stream("input.txt")};
-  std::istringstream iss{};
+// Equation `i` is `test_vals[i]: operands[i][0] operands[i][1] ...`.
+struct equations {
+  std::vector<u64> test_vals;
+  helper::Jagged<u64> operands;
+};
 
-  std::vector<std::pair<u64, std::vector<u64>>> res{};
+equations parse_input(std::string_view input) {
+  helper::number_scanner scanner{input};
 
-  std::string line{};
-  while (std::getline(ifs, line)) {
-    auto colon_pos = line.find(':');
-    u64 test_val = std::stol(line.substr(0, colon_pos));
+  equations res{};
 
-    iss.str(line.substr(colon_pos + 1));
-    iss.clear();
-    u64 operand = 0;
-    std::vector<u64> operands{};
-    while (iss >> operand) {
-      operands.emplace_back(operand);
+  // Each equation is `test_val: operand operand ...`, so a number followed by
+  // `:` opens a new equation and everything else is an operand of the last one.
+  u64 num = 0;
+  while (scanner.next(num)) {
+    if (scanner.delimiter() == ':') {
+      res.test_vals.emplace_back(num);
+      res.operands.start_row();
+    } else {
+      res.operands.push_back(num);
     }
-
-    res.emplace_back(test_val, std::move(operands));
   }
 
   return res;
@@ -88,44 +92,107 @@ std::vector<std::string> gen_all_op_seq(int const seq_len, bool for_part2 = fals
   return res;
 }
 
-u64 calc_total_calibration(std::vector<std::pair<u64, std::vector<u64>>> const& input_data, bool for_part2 = false) {
-  u64 sum = 0;
-
-  for (auto const& [test_val, operands] : input_data) {
-    bool found = false;
-    for (auto const& op_seq : gen_all_op_seq(operands.size() - 1, for_part2)) {
-      u64 temp = operands[0];
-      for (int i = 1; i < operands.size(); ++i) {
-        switch (op_seq[i - 1]) {
-          case '+': temp += operands[i]; break;
-          case '*': temp *= operands[i]; break;
-          case '|': temp = concat_nums(temp, operands[i]); break;
-          default: assert(false);
-        }
-      }
-
-      if (temp == test_val) {
-        found = true;
-        break;
+bool is_equation_solvable(u64 test_val, std::span<u64 const> operands, bool for_part2) {
+  for (auto const& op_seq : gen_all_op_seq(operands.size() - 1, for_part2)) {
+    u64 temp = operands[0];
+    for (int i = 1; i < operands.size(); ++i) {
+      switch (op_seq[i - 1]) {
+        case '+': temp += operands[i]; break;
+        case '*': temp *= operands[i]; break;
+        case '|': temp = concat_nums(temp, operands[i]); break;
+        default: assert(false);
       }
     }
 
-    if (found) {
-      sum += test_val;
+    if (temp == test_val) {
+      return true;
     }
   }
 
-  return sum;
+  return false;
+}
+
+// Equations are independent, so they are checked in parallel.
+u64 calc_total_calibration(equations const& input_data, bool for_part2 = false) {
+  return helper::thread_pool::global().parallel_reduce(0, input_data.test_vals.size(), u64{0}, [&](std::size_t eq) {
+    return is_equation_solvable(input_data.test_vals[eq], input_data.operands[eq], for_part2) ? input_data.test_vals[eq] : 0;
+  }, std::plus<u64>{});
+}
+
+// Both parts in one pass over a `chunk_reader`, one equation per line: an
+// equation solvable without `||` is solvable with it, too, so only the rest
+// are tried again with `||`.
+[[maybe_unused]] std::pair<u64, u64> calc_total_calibration_streaming(helper::chunk_reader& reader) {
+  u64 part1_sum = 0;
+  u64 part2_sum = 0;
+  std::vector<u64> operands{};
+  reader.for_each_line([&](std::string_view line) {
+    helper::number_scanner scanner{line};
+    u64 test_val = 0;
+    if (!scanner.next(test_val)) { return; }
+
+    operands.clear();
+    u64 operand = 0;
+    while (scanner.next(operand)) {
+      operands.emplace_back(operand);
+    }
+
+    if (is_equation_solvable(test_val, operands, false)) {
+      part1_sum += test_val;
+      part2_sum += test_val;
+    } else if (is_equation_solvable(test_val, operands, true)) {
+      part2_sum += test_val;
+    }
+  });
+  return {part1_sum, part2_sum};
+}
+
+[[maybe_unused]] helper::solution solve(std::string_view input) {
+  auto input_data = parse_input(input);
+  return {std::to_string(calc_total_calibration(input_data)),
+          std::to_string(calc_total_calibration(input_data, true))};
 }
 
-int main() {
-  auto input_data = parse_input();
+} // namespace
+
+#if defined(AOC_DRIVER)
+helper::register_day const registration{7, solve};
+#else
+int main(int argc, char* argv[]) {
+  // `./main <path>` (`-` for stdin) streams that input instead of solving `input.txt`.
+  if (argc > 1) {
+    helper::chunk_reader reader{argv[1]};
+    auto [part1_total_calibration, part2_total_calibration] = calc_total_calibration_streaming(reader);
+    std::cout << "Part 1: What is their total calibration result? " << part1_total_calibration << '\n';
+    std::cout << "Part 2: What is their total calibration result? " << part2_total_calibration << '\n';
+    return 0;
+  }
+
+  helper::mapped_file const file{"input.txt", helper::mapped_file::access_hint::sequential};
+  helper::benchmark bench{};
+
+  auto input_data = bench.run("parse_input", [&] { return parse_input(file.view()); });
 
-  u64 part1_total_calibration = calc_total_calibration(input_data);
+  u64 part1_total_calibration = bench.run("calc_total_calibration<part1>", [&] {
+    return calc_total_calibration(input_data);
+  });
   assert(2501605301465 == part1_total_calibration);
   std::cout << "Part 1: What is their total calibration result? " << part1_total_calibration << '\n';
 
-  u64 part2_total_calibration = calc_total_calibration(input_data, true);
+  u64 part2_total_calibration = bench.run("calc_total_calibration<part2>", [&] {
+    return calc_total_calibration(input_data, true);
+  });
   assert(44841372855953 == part2_total_calibration);
   std::cout << "Part 2: What is their total calibration result? " << part2_total_calibration << '\n';
+
+  if (bench.run_variants()) {
+    [[maybe_unused]] auto streaming_totals = bench.run("calc_total_calibration_streaming", [] {
+      helper::chunk_reader reader{"input.txt"};
+      return calc_total_calibration_streaming(reader);
+    });
+    assert(streaming_totals == std::pair(part1_total_calibration, part2_total_calibration));
+  }
+
+  bench.report();
 }
+#endif
@@ -2,39 +2,47 @@
 //
 // clang++ -std=gnu++20 -stdlib=libc++ main.cpp -o main && ./main && rm main
 
-#include <fstream>
+#include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 #include <utility>
-#include <numeric>
+#include <algorithm>
 #include <cassert>
 #include <iostream>
 
 #include "../aoc.h"
 
-using pos_t = std::pair<int, int>;
+namespace {
 
-std::vector<std::string> parse_input() {
-  std::ifstream ifs("input.txt");
-  std::vector<std::string> res{};
-  std::string row{};
-  while (std::getline(ifs, row)) {
-    res.emplace_back(std::move(row));
-  }
+using pos_t = std::pair<int, int>;
 
-  return res;
+helper::Grid<char> parse_input(std::string_view input) {
+  return helper::Grid<char>::parse(input);
 }
 
-std::unordered_map<char, std::vector<pos_t>> find_antennas(std::vector<std::string> const& map) {
-  std::unordered_map<char, std::vector<pos_t>> res{};
-  for (int i = 0; i < map.size(); i++) {
-    for (int j = 0; j < map[0].size(); ++j) {
-      if (map[i][j] == '.') { continue; }
-      res[map[i][j]].emplace_back(i, j); 
+using antenna_map = std::unordered_map<char, std::vector<pos_t>>;
+
+// Rows are scanned in bands on the pool. An antenna is a single cell, so the
+// bands need no halo; merging the band maps in row order keeps each
+// frequency's antennas in the same order as a serial scan.
+antenna_map find_antennas(helper::Grid<char> const& map) {
+  return helper::reduce_row_bands(map.rows(), 0, antenna_map{}, [&](int, int begin, int end) {
+    antenna_map res{};
+    for (int i = begin; i < end; i++) {
+      for (int j = 0; j < map.cols(); ++j) {
+        if (map(i, j) == '.') { continue; }
+        res[map(i, j)].emplace_back(i, j);
+      }
     }
-  }
-
-  return res;
+    return res;
+  }, [](antenna_map acc, antenna_map band) {
+    for (auto& [freq, antennas] : band) {
+      auto& all = acc[freq];
+      all.insert(all.end(), antennas.begin(), antennas.end());
+    }
+    return acc;
+  });
 }
 
 inline bool pos_in_bounds(pos_t const& p, int const rows, int const cols) {
@@ -73,9 +81,9 @@ void mark_antinodes<true>(pos_t const& p1, pos_t const& p2, int const rows, int
 }
 
 template<bool ForPart2>
-int find_all_antinodes(std::vector<std::string> const& map) {
-  int rows = map.size();
-  int cols = map[0].size();
+int find_all_antinodes(helper::Grid<char> const& map) {
+  int rows = map.rows();
+  int cols = map.cols();
 
   std::vector<bool> marked(rows * cols, false);
 
@@ -89,19 +97,33 @@ int find_all_antinodes(std::vector<std::string> const& map) {
     }
   }
 
-  return std::reduce(marked.cbegin(), marked.cend(), 0, [](int acc, bool marked) {
-    return acc + (marked ? 1 : 0);
-  });
+  return std::count(marked.cbegin(), marked.cend(), true);
+}
+
+[[maybe_unused]] helper::solution solve(std::string_view input) {
+  auto map = parse_input(input);
+  return {std::to_string(find_all_antinodes<false>(map)), std::to_string(find_all_antinodes<true>(map))};
 }
 
+} // namespace
+
+#if defined(AOC_DRIVER)
+helper::register_day const registration{8, solve};
+#else
 int main() {
-  auto map = parse_input();
+  helper::mapped_file const file{"input.txt", helper::mapped_file::access_hint::sequential};
+  helper::benchmark bench{};
+
+  auto map = bench.run("parse_input", [&] { return parse_input(file.view()); });
 
-  int unique_antinodes_cnt = find_all_antinodes<false>(map);
+  int unique_antinodes_cnt = bench.run("find_all_antinodes<false>", [&] { return find_all_antinodes<false>(map); });
   assert(unique_antinodes_cnt == 276);
   std::cout << "Part 1: How many unique locations within the bounds of the map contain an antinode? " << unique_antinodes_cnt << '\n';
 
-  unique_antinodes_cnt = find_all_antinodes<true>(map);
+  unique_antinodes_cnt = bench.run("find_all_antinodes<true>", [&] { return find_all_antinodes<true>(map); });
   assert(unique_antinodes_cnt == 991);
   std::cout << "Part 2: How many unique locations within the bounds of the map contain an antinode? " << unique_antinodes_cnt << '\n';
+
+  bench.report();
 }
+#endif
@@ -4,6 +4,7 @@
 
 #include <cstdint>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <utility>
 #include <iterator>
@@ -12,9 +13,11 @@
 
 #include "../aoc.h"
 
+namespace {
+
 using u64 = uint64_t;
 
-std::pair<std::vector<u64>, std::vector<std::pair<u64, u64>>> parse_disk_map(std::string const &disk_map) {
+std::pair<std::vector<u64>, std::vector<std::pair<u64, u64>>> parse_disk_map(std::string_view disk_map) {
   std::vector<u64> blocks{};
   std::vector<std::pair<u64, u64>> free_space_index{};
 
@@ -45,7 +48,7 @@ void part1_compact_files(std::vector<u64>& blocks) {
   }
 }
 
-void part2_compact_files(std::vector<u64>& blocks, std::string const &disk_map, std::vector<std::pair<u64, u64>>& free_space_index) {
+void part2_compact_files(std::vector<u64>& blocks, std::string_view disk_map, std::vector<std::pair<u64, u64>>& free_space_index) {
   auto calc_file_size = [&disk_map](u64 file_id) -> u64 {
     return disk_map[file_id * 2] - '0';
   };
@@ -103,19 +106,46 @@ u64 calculate_checksum(std::vector<u64> const& compacted_files) {
   return filesystem_checksum;
 }
 
-int main() {
-  std::string const disk_map = helper::read_file_as_string("input.txt");
+[[maybe_unused]] helper::solution solve(std::string_view disk_map) {
   auto [blocks, free_space_index] = parse_disk_map(disk_map);
 
   auto blocks_part1{blocks};
   part1_compact_files(blocks_part1);
-  u64 filesystem_checksum = calculate_checksum(blocks_part1);
+
+  part2_compact_files(blocks, disk_map, free_space_index);
+
+  return {std::to_string(calculate_checksum(blocks_part1)), std::to_string(calculate_checksum(blocks))};
+}
+
+} // namespace
+
+#if defined(AOC_DRIVER)
+helper::register_day const registration{9, solve};
+#else
+int main() {
+  helper::benchmark bench{};
+
+  helper::mapped_file const file{"input.txt", helper::mapped_file::access_hint::sequential};
+  std::string_view const disk_map{file.view()};
+  auto [blocks, free_space_index] = bench.run("parse_disk_map", [&] { return parse_disk_map(disk_map); });
+
+  u64 filesystem_checksum = bench.run("part1_compact_files", [&] {
+    auto blocks_part1{blocks};
+    part1_compact_files(blocks_part1);
+    return calculate_checksum(blocks_part1);
+  });
   assert(filesystem_checksum == 6216544403458);
   std::cout << "Part 1: What is the resulting filesystem checksum? " << filesystem_checksum << '\n';
 
-  auto blocks_part2{blocks};
-  part2_compact_files(blocks_part2, disk_map, free_space_index);
-  filesystem_checksum = calculate_checksum(blocks_part2);
+  filesystem_checksum = bench.run("part2_compact_files", [&] {
+    auto blocks_part2{blocks};
+    auto free_space_index_part2{free_space_index};
+    part2_compact_files(blocks_part2, disk_map, free_space_index_part2);
+    return calculate_checksum(blocks_part2);
+  });
   assert(filesystem_checksum == 6237075041489);
   std::cout << "Part 2: What is the resulting filesystem checksum? " << filesystem_checksum << '\n';
+
+  bench.report();
 }
+#endif
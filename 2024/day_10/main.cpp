@@ -2,120 +2,133 @@
 //
 // clang++ -std=gnu++20 -stdlib=libc++ main.cpp -o main && ./main && rm main
 
-#include <fstream>
 #include <string>
+#include <string_view>
 #include <vector>
-#include <array>
-#include <algorithm>
 #include <functional>
 #include <cassert>
 #include <iostream>
 
 #include "../aoc.h"
 
-// up, right, down, left
-constexpr std::array<std::pair<int, int>, 4> directions{{{-1, 0}, {0, 1}, {1, 0}, {0, -1}}};
+namespace {
 
-std::vector<std::vector<int>> parse_input() {
-  std::ifstream ifs{helper::read_file_as_stream("input.txt")};
+// Height of the one-cell frame around the map. It never equals `height + 1`
+// for any real height, so trails can't step off the map.
+constexpr int off_map = -1;
 
-  std::vector<std::vector<int>> map{};
-  std::string line{};
-  while (std::getline(ifs, line)) {
-    std::vector<int> row{};
-    for (auto const& c : line) {
-      row.emplace_back(c - '0');
-    }
-    map.emplace_back(std::move(row));
-  }
-
-  return map;
+helper::Grid<int> parse_input(std::string_view input) {
+  return helper::Grid<int>::parse(input, 1, off_map, [](char c) { return c - '0'; });
 }
 
-int calc_trailhead_scores_sum(std::vector<std::vector<int>> const& map) {
-  int const rows = map.size();
-  int const cols = map[0].size();
-
-  int visit_id = 0;
-  std::vector<int> visited(rows * cols, 0);
-
-  std::function<int(int, int)> dfs = [&](int row, int col) {
-    if (map[row][col] == 9) {
-      if (visited[cols * row + col] != visit_id) {
-        visited[cols * row + col] = visit_id;
-        return 1;
+// Trailheads are independent, so rows of them are scored in parallel.
+int calc_trailhead_scores_sum(helper::Grid<int> const& map) {
+  auto const directions = map.neighbor_offsets4();
+
+  // Each thread stamps the summits reached from its current trailhead with a
+  // fresh id, so its `visited` never needs clearing.
+  struct scratch {
+    int visit_id = 0;
+    std::vector<int> visited{};
+  };
+  helper::per_thread<scratch> scratches{};
+
+  return helper::thread_pool::global().parallel_reduce(0, map.rows(), 0, [&](std::size_t i) {
+    int& visit_id = scratches.local().visit_id;
+    std::vector<int>& visited = scratches.local().visited;
+    if (visited.empty()) { visited.assign(map.buffer_size(), 0); }
+
+    std::function<int(int)> dfs = [&](int pos) {
+      AOC_COUNT("calc_trailhead_scores_sum.dfs");
+      if (map[pos] == 9) {
+        if (visited[pos] != visit_id) {
+          visited[pos] = visit_id;
+          return 1;
+        }
+
+        return 0;
       }
 
-      return 0;
-    }
-
-    int score = 0;
-    for (auto const& [drow, dcol] : directions) {
-      int next_row = row + drow;
-      int next_col = col + dcol;
-      if (next_row >= 0 && next_row < rows && next_col >= 0 && next_col < cols
-          && map[next_row][next_col] == map[row][col] + 1) {
-        score += dfs(next_row, next_col);
+      int score = 0;
+      for (int step : directions) {
+        if (map[pos + step] == map[pos] + 1) {
+          score += dfs(pos + step);
+        }
       }
-    }
 
-    return score;
-  }; // dfs
+      return score;
+    }; // dfs
 
-  int sum = 0;
-  for (int i = 0; i < rows; ++i) {
-    for (int j = 0; j < cols; ++j) {
-      if (map[i][j] != 0) { continue; }
+    int sum = 0;
+    for (int j = 0; j < map.cols(); ++j) {
+      if (map(i, j) != 0) { continue; }
       ++visit_id;
-      sum += dfs(i, j);
+      sum += dfs(map.index(i, j));
     }
-  }
-
-  return sum;
+    return sum;
+  }, std::plus<int>{});
 }
 
-int calc_trailhead_ratings_sum(std::vector<std::vector<int>> const& map) {
-  int const rows = map.size();
-  int const cols = map[0].size();
+// Rows of trailheads are rated in parallel. Each thread keeps its own memo,
+// so a slope reachable from two threads' trailheads is at worst explored
+// twice, never raced on.
+int calc_trailhead_ratings_sum(helper::Grid<int> const& map) {
+  auto const directions = map.neighbor_offsets4();
+
+  helper::per_thread<std::vector<int>> memos{};
 
-  std::vector<std::vector<int>> memo(rows, std::vector<int>(cols, -1));
+  return helper::thread_pool::global().parallel_reduce(0, map.rows(), 0, [&](std::size_t i) {
+    auto& memo = memos.local();
+    if (memo.empty()) { memo.assign(map.buffer_size(), -1); }
 
-  std::function<int(int, int)> dfs = [&](int row, int col) {
-    if (map[row][col] == 9) { return 1; }
-    if (memo[row][col] != -1) { return memo[row][col]; }
+    std::function<int(int)> dfs = [&](int pos) {
+      AOC_COUNT("calc_trailhead_ratings_sum.dfs");
+      if (map[pos] == 9) { return 1; }
+      if (memo[pos] != -1) { return memo[pos]; }
 
-    int total_trails = 0;
-    for (auto const& [drow, dcol] : directions) {
-      int next_row = row + drow;
-      int next_col = col + dcol;
-      if (next_row >= 0 && next_row < rows && next_col >= 0 && next_col < cols
-          && map[next_row][next_col] == map[row][col] + 1) {
-        total_trails += dfs(next_row, next_col);
+      int total_trails = 0;
+      for (int step : directions) {
+        if (map[pos + step] == map[pos] + 1) {
+          total_trails += dfs(pos + step);
+        }
       }
-    }
 
-    memo[row][col] = total_trails;
-    return total_trails;
-  }; // dfs
+      memo[pos] = total_trails;
+      return total_trails;
+    }; // dfs
 
-  int sum = 0;
-  for (int i = 0; i < rows; ++i) {
-    for (int j = 0; j < cols; ++j) {
-      if (map[i][j] == 0) { sum += dfs(i, j); }
+    int sum = 0;
+    for (int j = 0; j < map.cols(); ++j) {
+      if (map(i, j) == 0) { sum += dfs(map.index(i, j)); }
     }
-  }
+    return sum;
+  }, std::plus<int>{});
+}
 
-  return sum;
+[[maybe_unused]] helper::solution solve(std::string_view input) {
+  auto map = parse_input(input);
+  return {std::to_string(calc_trailhead_scores_sum(map)), std::to_string(calc_trailhead_ratings_sum(map))};
 }
 
+} // namespace
+
+#if defined(AOC_DRIVER)
+helper::register_day const registration{10, solve};
+#else
 int main() {
-  auto map = parse_input();
+  helper::mapped_file const file{"input.txt", helper::mapped_file::access_hint::sequential};
+  helper::benchmark bench{};
+
+  auto map = bench.run("parse_input", [&] { return parse_input(file.view()); });
 
-  int scores_sum = calc_trailhead_scores_sum(map);
+  int scores_sum = bench.run("calc_trailhead_scores_sum", [&] { return calc_trailhead_scores_sum(map); });
   assert(607 == scores_sum);
   std::cout << "What is the sum of the scores of all trailheads on your topographic map? " << scores_sum << '\n';
 
-  int ratings_sum = calc_trailhead_ratings_sum(map);
+  int ratings_sum = bench.run("calc_trailhead_ratings_sum", [&] { return calc_trailhead_ratings_sum(map); });
   assert(1384 == ratings_sum);
   std::cout << "What is the sum of the ratings of all trailheads? " << ratings_sum << "\n";
+
+  bench.report();
 }
+#endif
@@ -3,6 +3,8 @@
 // clang++ -std=gnu++20 -stdlib=libc++ main.cpp -o main && ./main && rm main
 
 #include <cstdint>
+#include <string>
+#include <string_view>
 #include <vector>
 #include <unordered_map>
 #include <functional>
@@ -11,13 +13,39 @@
 #include <cassert>
 #include <iostream>
 
+#include "../aoc.h"
+
+namespace {
+
 using u64 = uint64_t;
 
-void solve_part1() {
-  std::vector<u64> const prog{2, 4, 1, 2, 7, 5, 4, 5, 1, 3, 5, 5, 0, 3, 3, 0};
-  u64 ar = 64751475;
+struct computer {
+  u64 ar = 0;
   u64 br = 0;
   u64 cr = 0;
+  std::vector<u64> prog{};
+};
+
+computer parse_input(std::string_view input) {
+  helper::number_scanner scanner{input};
+
+  computer res{};
+  scanner.next(res.ar);
+  scanner.next(res.br);
+  scanner.next(res.cr);
+  u64 value;
+  while (scanner.next(value)) {
+    res.prog.emplace_back(value);
+  }
+
+  return res;
+}
+
+std::vector<u64> solve_part1(computer const& input) {
+  std::vector<u64> const& prog = input.prog;
+  u64 ar = input.ar;
+  u64 br = input.br;
+  u64 cr = input.cr;
   u64 ip = 0;
 
   auto combo_operand = [&](u64 operand) {
@@ -42,15 +70,11 @@ void solve_part1() {
 
   while (ip < prog.size() - 1) { opcode2insts[prog[ip++]](prog[ip++]); }
 
-  // assert((res == std::vector<u64>{3, 1, 4, 3, 1, 7, 1, 6, 3}));
-  std::cout << "Part 1: What do you get if you use commas to join the values it output into a single string? ";
-  for (int i = 0; i < res.size(); ++i) {
-    std::cout << res[i] << (i == res.size() - 1 ? '\n' : ',');
-  }
+  return res;
 }
 
-void solve_part2() {
-  std::vector<u64> const prog{2, 4, 1, 2, 7, 5, 4, 5, 1, 3, 5, 5, 0, 3, 3, 0};
+// Only works for the program in `input.txt`, which `output` below hand-compiles.
+u64 solve_part2(std::vector<u64> const& prog) {
   // For the input `prog`, the following instructions will be executed one by one:
   //
   // 1) 2,4: br = ar & 7
@@ -92,11 +116,40 @@ void solve_part2() {
   };
 
   backtrack(prog.size() - 1, 0);
-  assert(37221270076916 == lowest_init_ar);
-  std::cout << "Part 2: What is the lowest positive initial value for register A that causes the program to output a copy of itself? " << lowest_init_ar << '\n';
+  return lowest_init_ar;
 }
 
+[[maybe_unused]] helper::solution solve(std::string_view input) {
+  auto computer = parse_input(input);
+  std::string output{};
+  for (u64 value : solve_part1(computer)) {
+    output += (output.empty() ? "" : ",") + std::to_string(value);
+  }
+  return {output, std::to_string(solve_part2(computer.prog))};
+}
+
+} // namespace
+
+#if defined(AOC_DRIVER)
+helper::register_day const registration{17, solve};
+#else
 int main() {
-  solve_part1();
-  solve_part2();
+  helper::mapped_file const file{"input.txt", helper::mapped_file::access_hint::sequential};
+  helper::benchmark bench{};
+
+  auto input = bench.run("parse_input", [&] { return parse_input(file.view()); });
+
+  auto output = bench.run("solve_part1", [&] { return solve_part1(input); });
+  // assert((output == std::vector<u64>{3, 1, 4, 3, 1, 7, 1, 6, 3}));
+  std::cout << "Part 1: What do you get if you use commas to join the values it output into a single string? ";
+  for (int i = 0; i < output.size(); ++i) {
+    std::cout << output[i] << (i == output.size() - 1 ? '\n' : ',');
+  }
+
+  u64 lowest_init_ar = bench.run("solve_part2", [&] { return solve_part2(input.prog); });
+  assert(37221270076916 == lowest_init_ar);
+  std::cout << "Part 2: What is the lowest positive initial value for register A that causes the program to output a copy of itself? " << lowest_init_ar << '\n';
+
+  bench.report();
 }
+#endif
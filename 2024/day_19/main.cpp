@@ -2,52 +2,62 @@
 //
 // clang++ -std=gnu++20 -stdlib=libc++ main.cpp -o main && ./main && rm main
 
-#include <fstream>
-#include <sstream>
 #include <vector>
 #include <utility>
-#include <unordered_set>
 #include <string>
-#include <limits>
-#include <numeric>
+#include <string_view>
+#include <algorithm>
+#include <functional>
 #include <cassert>
 #include <iostream>
 
 #include "../aoc.h"
 
+namespace {
+
 using namespace std;
 
-pair<unordered_set<string>, vector<string>> parse_input() {
-  auto ifs{helper::read_file_as_stream("input.txt")};
-
-  string line{};
-  getline(ifs, line);
-  istringstream iss{std::move(line)};
-  unordered_set<string> patterns{};
-  string pattern{};
-  while (getline(iss, pattern, ',')) {
-    patterns.emplace(std::move(pattern));
-    iss.ignore(numeric_limits<streamsize>::max(), ' ');
+// The towel patterns, interned so a design's substrings can be looked up
+// without building a `string` for each one.
+struct towel_patterns {
+  helper::Interner names{};
+  size_t max_len = 0;
+
+  bool contains(string_view stripes) const {
+    return stripes.size() <= max_len && names.contains(stripes);
+  }
+};
+
+pair<towel_patterns, vector<string>> parse_input(string_view input) {
+
+  towel_patterns patterns{};
+  string_view line = helper::pop_line(input);
+  while (!line.empty()) {
+    size_t const comma = line.find(',');
+    string_view const pattern = line.substr(0, comma);
+    patterns.names.intern(pattern);
+    patterns.max_len = max(patterns.max_len, pattern.size());
+    line.remove_prefix(comma == string_view::npos ? line.size() : comma + 1);
+    while (line.starts_with(' ')) { line.remove_prefix(1); }
   }
 
-  ifs.ignore(numeric_limits<streamsize>::max(), '\n');
+  helper::pop_line(input);
 
   vector<string> designs{};
-  while (getline(ifs, line)) {
-    designs.emplace_back(std::move(line));
+  while (!input.empty()) {
+    designs.emplace_back(helper::pop_line(input));
   }
 
-  return {patterns, designs};
+  return {std::move(patterns), std::move(designs)};
 }
 
-bool is_design_possible(unordered_set<string> const& patterns, string const& design) {
+bool is_design_possible(towel_patterns const& patterns, string_view design) {
   vector<bool> dp(design.size() + 1, false);
   dp[0] = true;
 
-  for (int i = 1; i < dp.size(); ++i) {
-    for (auto const& pattern : patterns) {
-      int len = pattern.size();
-      if (i >= len && dp[i - len] && pattern == design.substr(i - len, len)) {
+  for (size_t i = 1; i < dp.size(); ++i) {
+    for (size_t len = 1; len <= min(i, patterns.max_len); ++len) {
+      if (dp[i - len] && patterns.contains(design.substr(i - len, len))) {
         dp[i] = true;
         break;
       }
@@ -57,22 +67,20 @@ bool is_design_possible(unordered_set<string> const& patterns, string const& des
   return dp[design.size()];
 }
 
-void solve_part1(unordered_set<string> const& patterns, vector<string> const& designs) {
-  int res = reduce(designs.cbegin(), designs.cend(), 0, [&patterns](int acc, string const& design) {
-    return acc + (is_design_possible(patterns, design) ? 1 : 0);
-  });
-  assert(313 == res);
-  cout << "Part 1: How many designs are possible? " << res << '\n';
+// Designs are independent, so their DPs run in parallel.
+int solve_part1(towel_patterns const& patterns, vector<string> const& designs) {
+  return helper::thread_pool::global().parallel_reduce(0, designs.size(), 0, [&](size_t i) {
+    return is_design_possible(patterns, designs[i]) ? 1 : 0;
+  }, plus<int>{});
 }
 
-uint64_t count_possible_options(unordered_set<string> const& patterns, string const& design) {
+uint64_t count_possible_options(towel_patterns const& patterns, string_view design) {
   vector<uint64_t> dp(design.size() + 1, 0);
   dp[0] = 1;
 
-  for (int i = 1; i < dp.size(); ++i) {
-    for (auto const& pattern : patterns) {
-      int len = pattern.size();
-      if (i >= len && pattern == design.substr(i - len, len)) {
+  for (size_t i = 1; i < dp.size(); ++i) {
+    for (size_t len = 1; len <= min(i, patterns.max_len); ++len) {
+      if (dp[i - len] != 0 && patterns.contains(design.substr(i - len, len))) {
         dp[i] += dp[i - len];
       }
     }
@@ -81,18 +89,38 @@ uint64_t count_possible_options(unordered_set<string> const& patterns, string co
   return dp[design.size()];
 }
 
-void solve_part2(unordered_set<string> const& patterns, vector<string> const& designs) {
-  // Note: Make sure the initial value in `std::reduce` has the correct 
-  // type (`uint64_t`), or else it will overflow and yield incorrect results.
-  uint64_t res = reduce(designs.cbegin(), designs.cend(), uint64_t{0}, [&patterns](uint64_t acc, string const& design) {
-    return acc + count_possible_options(patterns, design);
-  });
-  assert(666491493769758 == res);
-  cout << "Part 2: What do you get if you add up the number of different ways you could make each design? " << res << '\n';
+uint64_t solve_part2(towel_patterns const& patterns, vector<string> const& designs) {
+  // Note: Make sure the initial value has the correct type (`uint64_t`), or
+  // else it will overflow and yield incorrect results.
+  return helper::thread_pool::global().parallel_reduce(0, designs.size(), uint64_t{0}, [&](size_t i) {
+    return count_possible_options(patterns, designs[i]);
+  }, plus<uint64_t>{});
+}
+
+[[maybe_unused]] helper::solution solve(string_view input) {
+  auto [patterns, designs] = parse_input(input);
+  return {to_string(solve_part1(patterns, designs)), to_string(solve_part2(patterns, designs))};
 }
 
+} // namespace
+
+#if defined(AOC_DRIVER)
+helper::register_day const registration{19, solve};
+#else
 int main() {
-  auto [patterns, designs] = parse_input();
-  solve_part1(patterns, designs);
-  solve_part2(patterns, designs);
+  helper::mapped_file const file{"input.txt", helper::mapped_file::access_hint::sequential};
+  helper::benchmark bench{};
+
+  auto [patterns, designs] = bench.run("parse_input", [&] { return parse_input(file.view()); });
+
+  int possible_designs = bench.run("solve_part1", [&] { return solve_part1(patterns, designs); });
+  assert(313 == possible_designs);
+  cout << "Part 1: How many designs are possible? " << possible_designs << '\n';
+
+  uint64_t options = bench.run("solve_part2", [&] { return solve_part2(patterns, designs); });
+  assert(666491493769758 == options);
+  cout << "Part 2: What do you get if you add up the number of different ways you could make each design? " << options << '\n';
+
+  bench.report();
 }
+#endif
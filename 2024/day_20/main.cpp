@@ -2,10 +2,10 @@
 //
 // clang++ -std=gnu++20 -stdlib=libc++ main.cpp -o main && ./main && rm main
 
+#include <string>
+#include <string_view>
 #include <vector>
 #include <utility>
-#include <fstream>
-#include <string>
 #include <numeric>
 #include <algorithm>
 #include <array>
@@ -17,53 +17,38 @@
 
 #include "../aoc.h"
 
-constexpr std::array<std::pair<int, int>, 4> directions{{{-1, 0}, {0, 1}, {1, 0}, {0, -1}}};
+namespace {
 
-std::vector<std::string> parse_input() {
-  std::ifstream ifs{helper::read_file_as_stream("input.txt")};
-
-  std::vector<std::string> map{};
-  std::string row{};
-  while (std::getline(ifs, row)) {
-    map.emplace_back(std::move(row));
-  }
+// The longest cheat allowed. The map is framed by this many wall cells, so a
+// cheat never has to check whether it ends outside the map.
+constexpr int max_cheat = 20;
 
-  return map;
+helper::Grid<char> parse_input(std::string_view input) {
+  return helper::Grid<char>::parse(input, max_cheat, '#');
 }
 
-std::vector<std::pair<int, int>> find_path_without_cheat(std::vector<std::string> const& map) {
-  int const rows = map.size();
-  int const cols = map[0].size();
+std::vector<std::pair<int, int>> find_path_without_cheat(helper::Grid<char> const& map) {
+  auto const directions = map.neighbor_offsets4();
 
-  std::pair<int, int> start{-1, -1};
-  for (int i = 0; i < rows; ++i) {
-    auto found = map[i].find('S');
-    if (found != std::string::npos) {
-      start = {i, found};
-      break;
-    }
-  }
+  int const start = map.find('S');
 
-  std::vector<std::pair<int, int>> path{start};
-  std::unordered_set<int> visited{cols * start.first + start.second};
+  std::vector<std::pair<int, int>> path{{map.row_of(start), map.col_of(start)}};
+  std::vector<bool> visited(map.buffer_size(), false);
+  visited[start] = true;
 
+  int pos = start;
   bool reach_end = false;
   while (!reach_end) {
-    for (auto const [dr, dc] : directions) {
-      auto [r, c] = path.back();
-      int nr = r + dr;
-      int nc = c + dc;
-      if (nr < 0 || nr >= rows || nc < 0 || nc >= cols) { continue; }
-      if (visited.contains(cols * nr + nc)) { continue; }
-
-      char cell = map[nr][nc];
-      if (cell == '.') {
-        path.emplace_back(nr, nc);
-        visited.emplace(cols * nr + nc);
-        break;
-      } else if (cell == 'E') {
-        path.emplace_back(nr, nc);
-        reach_end = true;
+    for (int step : directions) {
+      int next = pos + step;
+      if (visited[next]) { continue; }
+
+      char cell = map[next];
+      if (cell == '.' || cell == 'E') {
+        path.emplace_back(map.row_of(next), map.col_of(next));
+        visited[next] = true;
+        pos = next;
+        reach_end = cell == 'E';
         break;
       }
     } // for
@@ -72,7 +57,7 @@ std::vector<std::pair<int, int>> find_path_without_cheat(std::vector<std::string
   return path;
 }
 
-uint64_t pos_pair_hash_on_map(int p1_row, int p1_col, int p2_row, int p2_col, std::vector<std::string> const& map) {
+uint64_t pos_pair_hash_on_map(int p1_row, int p1_col, int p2_row, int p2_col, helper::Grid<char> const& map) {
   int bit_width = [](uint64_t n) {
     int width = 0;
     while (n > 0) {
@@ -80,7 +65,7 @@ uint64_t pos_pair_hash_on_map(int p1_row, int p1_col, int p2_row, int p2_col, st
       n >>= 1;
     }
     return width;
-  }(map.size());
+  }(map.rows());
 
   return (static_cast<uint64_t>(p1_row) << (bit_width * 3)) +
          (static_cast<uint64_t>(p1_col) << (bit_width * 2)) +
@@ -88,7 +73,7 @@ uint64_t pos_pair_hash_on_map(int p1_row, int p1_col, int p2_row, int p2_col, st
          static_cast<uint64_t>(p2_col);
 }
 
-void solve_part1(std::vector<std::string> const& map, std::vector<std::pair<int, int>> const& path) {
+int solve_part1(helper::Grid<char> const& map, std::vector<std::pair<int, int>> const& path) {
   int res = 0;
   std::unordered_set<uint64_t> visited{};
 
@@ -109,22 +94,15 @@ void solve_part1(std::vector<std::string> const& map, std::vector<std::pair<int,
     } // for: j
   } // for: i
 
-  assert(res == 1415);
-  std::cout << "Part 1: How many cheats would save you at least 100 picoseconds? " << res << std::endl;
+  return res;
 }
 
-void solve_part2(std::vector<std::string> const& map, std::vector<std::pair<int, int>> const& path) {
-  int const rows = map.size();
-  int const cols = map[0].size();
-
-  auto in_bounds = [&rows, &cols](int row, int col) {
-    return row >= 0 && row < rows && col >= 0 && col < cols;
-  };
-
-  std::vector<int> pos2idx(rows * cols, -1);
+int solve_part2(helper::Grid<char> const& map, std::vector<std::pair<int, int>> const& path) {
+  // Off-track cells, including the `max_cheat`-wide frame, map to -1.
+  helper::Grid<int> pos2idx(map.rows(), map.cols(), -1, max_cheat, -1);
   for (int i = 0; i < path.size(); ++i) {
     auto [row, col] = path[i];
-    pos2idx[cols * row + col] = i;
+    pos2idx(row, col) = i;
   }
 
   struct dir { int x, y; };
@@ -134,13 +112,12 @@ void solve_part2(std::vector<std::string> const& map, std::vector<std::pair<int,
 
   for (int i = 0; i < path.size(); ++i) {
     auto [cheat_start_row, cheat_start_col] = path[i];
-    for (int cheating_rule = 2; cheating_rule <= 20; ++cheating_rule) {
+    for (int cheating_rule = 2; cheating_rule <= max_cheat; ++cheating_rule) {
       for (int drow = 0; drow <= cheating_rule; ++drow) {
         for (auto [x, y] : {dir{1, 1}, dir{-1, 1}, dir{-1, -1}, dir{1, -1}}) {
           int cheat_end_row = cheat_start_row + x * drow;
           int cheat_end_col = cheat_start_col + y * (cheating_rule - drow);
-          if (!in_bounds(cheat_end_row, cheat_end_col)) { continue; }
-          if (int j = pos2idx[cols * cheat_end_row + cheat_end_col]; j == -1 || (j - i) - cheating_rule < 100) { continue; }
+          if (int j = pos2idx(cheat_end_row, cheat_end_col); j == -1 || (j - i) - cheating_rule < 100) { continue; }
 
           if (uint64_t hash = pos_pair_hash_on_map(cheat_start_row, cheat_start_col, cheat_end_row, cheat_end_col, map);
             !visited.contains(hash)) {
@@ -152,13 +129,35 @@ void solve_part2(std::vector<std::string> const& map, std::vector<std::pair<int,
     } // for: cheating_rule
   } // for: i
 
-  assert(1022577 == res);
-  std::cout << "Part 2: How many cheats would save you at least 100 picoseconds? " << res << std::endl;
+  return res;
 }
 
-int main() {
-  auto map = parse_input();
+[[maybe_unused]] helper::solution solve(std::string_view input) {
+  auto map = parse_input(input);
   auto path = find_path_without_cheat(map);
-  solve_part1(map, path);
-  solve_part2(map, path);
+  return {std::to_string(solve_part1(map, path)), std::to_string(solve_part2(map, path))};
+}
+
+} // namespace
+
+#if defined(AOC_DRIVER)
+helper::register_day const registration{20, solve};
+#else
+int main() {
+  helper::mapped_file const file{"input.txt", helper::mapped_file::access_hint::sequential};
+  helper::benchmark bench{};
+
+  auto map = bench.run("parse_input", [&] { return parse_input(file.view()); });
+  auto path = bench.run("find_path_without_cheat", [&] { return find_path_without_cheat(map); });
+
+  int res = bench.run("solve_part1", [&] { return solve_part1(map, path); });
+  assert(res == 1415);
+  std::cout << "Part 1: How many cheats would save you at least 100 picoseconds? " << res << std::endl;
+
+  res = bench.run("solve_part2", [&] { return solve_part2(map, path); });
+  assert(1022577 == res);
+  std::cout << "Part 2: How many cheats would save you at least 100 picoseconds? " << res << std::endl;
+
+  bench.report();
 }
+#endif
@@ -2,12 +2,15 @@
 //
 // clang++ -std=gnu++20 -stdlib=libc++ main.cpp -o main && ./main && rm main
 
+#include <cstdint>
 #include <utility>
 #include <vector>
+#include <span>
 #include <string>
-#include <unordered_map>
-#include <unordered_set>
+#include <string_view>
+#include <iterator>
 #include <algorithm>
+#include <numeric>
 #include <cassert>
 #include <iostream>
 
@@ -15,83 +18,107 @@
 
 namespace {
 
-std::unordered_set<std::string> set_intersection(std::unordered_set<std::string> const& a, std::unordered_set<std::string> const& b) {
-  auto const& smaller = a.size() < b.size() ? a : b;
-  auto const& larger = a.size() < b.size() ? b : a;
+// Computers are interned to dense ids; `neighbors[id]` is sorted, so the set
+// operations below are linear merges over plain integers.
+struct network {
+  helper::Interner names{};
+  helper::Jagged<uint32_t> neighbors{};
+};
 
-  std::unordered_set<std::string> res{};
-  for (auto const& e : smaller) {
-    if (larger.contains(e)) { res.emplace(e); }
-  }
+using node_set = std::vector<uint32_t>;
+
+node_set set_intersection(std::span<uint32_t const> a, std::span<uint32_t const> b) {
+  node_set res{};
+  res.reserve(std::min(a.size(), b.size()));
+  std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(res));
   return res;
 }
 
-std::unordered_set<std::string> set_union(std::unordered_set<std::string> const& a, std::unordered_set<std::string> const& b) {
-  std::unordered_set<std::string> res{a};
-  for (auto const& e : b) {
-    res.emplace(e);
-  }
+node_set set_union(std::span<uint32_t const> a, std::span<uint32_t const> b) {
+  node_set res{};
+  res.reserve(a.size() + b.size());
+  std::set_union(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(res));
   return res;
 }
 
-std::unordered_set<std::string> set_difference(std::unordered_set<std::string> const& in, std::unordered_set<std::string> const& notin) {
-  std::unordered_set<std::string> res{};
-  for (auto const& e : in) {
-    if (!notin.contains(e)) { res.emplace(e); }
-  }
+node_set set_difference(std::span<uint32_t const> in, std::span<uint32_t const> notin) {
+  node_set res{};
+  res.reserve(in.size());
+  std::set_difference(in.begin(), in.end(), notin.begin(), notin.end(), std::back_inserter(res));
   return res;
 }
 
-} // namespace
+void erase_sorted(node_set& set, uint32_t node) {
+  set.erase(std::lower_bound(set.begin(), set.end(), node));
+}
 
-std::vector<std::pair<std::string, std::string>> parse_input() {
-  std::vector<std::pair<std::string, std::string>> edges{};
-  std::ifstream ifs{helper::read_file_as_stream("input.txt")};
-  std::string line{};
-  while (std::getline(ifs, line)) {
-    auto pos = line.find('-');
-    edges.emplace_back(line.substr(0, pos), line.substr(pos + 1));
-  }
-  return edges;
+void insert_sorted(node_set& set, uint32_t node) {
+  set.insert(std::lower_bound(set.begin(), set.end(), node), node);
 }
 
-std::unordered_map<std::string, std::unordered_set<std::string>>
-build_graph(std::vector<std::pair<std::string, std::string>> const& edges) {
-  std::unordered_map<std::string, std::unordered_set<std::string>> adj_list{};
+network parse_input(std::string_view input) {
+  network net{};
+  std::vector<std::pair<uint32_t, uint32_t>> edges{};
+  while (!input.empty()) {
+    std::string_view const line = helper::pop_line(input);
+    auto const pos = line.find('-');
+    if (pos == std::string_view::npos) { continue; }
+    uint32_t const u = net.names.intern(line.substr(0, pos));
+    uint32_t const v = net.names.intern(line.substr(pos + 1));
+    edges.emplace_back(u, v);
+  }
+
+  std::vector<node_set> adj_list(net.names.size());
   for (auto const& [u, v] : edges) {
-    adj_list[u].emplace(v);
-    adj_list[v].emplace(u);
+    adj_list[u].emplace_back(v);
+    adj_list[v].emplace_back(u);
+  }
+  net.neighbors.reserve(adj_list.size(), edges.size() * 2);
+  for (auto& neighbors : adj_list) {
+    std::sort(neighbors.begin(), neighbors.end());
+    neighbors.erase(std::unique(neighbors.begin(), neighbors.end()), neighbors.end());
+    net.neighbors.add_row(neighbors);
   }
-  return adj_list;
+
+  return net;
 }
 
-void solve_part1(std::unordered_map<std::string, std::unordered_set<std::string>> const& graph) {
+int solve_part1(network const& net) {
+  std::vector<bool> starts_with_t(net.names.size());
+  for (uint32_t u = 0; u < net.names.size(); ++u) {
+    starts_with_t[u] = net.names.name(u).starts_with('t');
+  }
+
   int count = 0;
-  for (auto const& [u, neighbors] : graph) {
-    for (auto const& v : neighbors) {
-      for (auto const& w : neighbors) {
-        if ((u < v && v < w)
-            && (u.starts_with('t') || v.starts_with('t') || w.starts_with('t'))
-            && graph.at(v).contains(w)) {
+  for (uint32_t u = 0; u < net.names.size(); ++u) {
+    auto const neighbors = net.neighbors[u];
+    // Each triangle is counted once, from its smallest id.
+    for (auto v_it = std::upper_bound(neighbors.begin(), neighbors.end(), u); v_it != neighbors.end(); ++v_it) {
+      uint32_t const v = *v_it;
+      auto const v_neighbors = net.neighbors[v];
+      for (auto w_it = std::next(v_it); w_it != neighbors.end(); ++w_it) {
+        uint32_t const w = *w_it;
+        if ((starts_with_t[u] || starts_with_t[v] || starts_with_t[w])
+            && std::binary_search(v_neighbors.begin(), v_neighbors.end(), w)) {
           ++count;
         }
       }
     }
   }
 
-  assert(1419 == count);
-  std::cout << "Part 1: How many contain at least one computer with a name that starts with t? " << count << '\n';
+  return count;
 }
 
 // Find a maximum clique
 // https://en.wikipedia.org/wiki/Bron%E2%80%93Kerbosch_algorithm
 //
 // Note: While a maximum (i.e., largest) clique is necessarily maximal, the converse does not hold.
-void bron_kerbosch_no_pivot(std::unordered_set<std::string> clique,
-                            std::unordered_set<std::string> potential,
-                            std::unordered_set<std::string> excluded,
-                            std::unordered_map<std::string, std::unordered_set<std::string>> const& graph,
-                            std::unordered_set<std::string>& maximum_clique) {
+void bron_kerbosch_no_pivot(node_set clique,
+                            node_set potential,
+                            node_set excluded,
+                            network const& net,
+                            node_set& maximum_clique) {
+  AOC_COUNT("bron_kerbosch_no_pivot.calls");
   if (potential.empty() && excluded.empty()) {
     if (clique.size() > maximum_clique.size()) {
       maximum_clique.swap(clique);
@@ -100,22 +127,23 @@ void bron_kerbosch_no_pivot(std::unordered_set<std::string> clique,
   }
 
   auto candidates{potential};
-  for (auto const& node : candidates) {
-    bron_kerbosch_no_pivot(set_union(clique, {node}), 
-                           set_intersection(potential, graph.at(node)),
-                           set_intersection(excluded, graph.at(node)), 
-                           graph, 
+  for (uint32_t node : candidates) {
+    bron_kerbosch_no_pivot(set_union(clique, {&node, 1}),
+                           set_intersection(potential, net.neighbors[node]),
+                           set_intersection(excluded, net.neighbors[node]),
+                           net,
                            maximum_clique);
-    potential.erase(node);
-    excluded.emplace(node);
+    erase_sorted(potential, node);
+    insert_sorted(excluded, node);
   }
 }
 
-void bron_kerbosch(std::unordered_set<std::string> clique,
-                   std::unordered_set<std::string> potential,
-                   std::unordered_set<std::string> excluded,
-                   std::unordered_map<std::string, std::unordered_set<std::string>> const& graph,
-                   std::unordered_set<std::string>& maximum_clique) {
+void bron_kerbosch(node_set clique,
+                   node_set potential,
+                   node_set excluded,
+                   network const& net,
+                   node_set& maximum_clique) {
+  AOC_COUNT("bron_kerbosch.calls");
   if (potential.empty() && excluded.empty()) {
     if (clique.size() > maximum_clique.size()) {
       maximum_clique.swap(clique);
@@ -123,49 +151,78 @@ void bron_kerbosch(std::unordered_set<std::string> clique,
     return;
   }
 
-  std::string pivot{};
+  uint32_t pivot;
   if (!potential.empty()) {
-    pivot = *potential.begin();
+    pivot = potential.front();
   } else if (!excluded.empty()) {
-    pivot = *excluded.begin();
+    pivot = excluded.front();
   } else {
     return;
   }
 
-  auto candidates{set_difference(potential, graph.at(pivot))};
-  for (auto const& node : candidates) {
-    bron_kerbosch(set_union(clique, {node}),
-                  set_intersection(potential, graph.at(node)),
-                  set_intersection(excluded, graph.at(node)),
-                  graph,
+  auto candidates{set_difference(potential, net.neighbors[pivot])};
+  for (uint32_t node : candidates) {
+    bron_kerbosch(set_union(clique, {&node, 1}),
+                  set_intersection(potential, net.neighbors[node]),
+                  set_intersection(excluded, net.neighbors[node]),
+                  net,
                   maximum_clique);
-    potential.erase(node);
-    excluded.emplace(node);
+    erase_sorted(potential, node);
+    insert_sorted(excluded, node);
   }
 }
 
-void solve_part2(std::unordered_map<std::string, std::unordered_set<std::string>> const& graph) {
-  std::unordered_set<std::string> maximum_clique{};
-  std::unordered_set<std::string> potential{};
-  for (auto const& [u, _] : graph) { potential.emplace(u); }
+// `find_maximum_clique` is either `bron_kerbosch` or `bron_kerbosch_no_pivot`.
+std::string solve_part2(network const& net, decltype(&bron_kerbosch) find_maximum_clique = bron_kerbosch) {
+  node_set maximum_clique{};
+  node_set potential(net.names.size());
+  std::iota(potential.begin(), potential.end(), 0);
 
-  // bron_kerbosch_no_pivot({}, potential, {}, graph, maximum_clique);
-  bron_kerbosch({}, potential, {}, graph, maximum_clique);
+  find_maximum_clique({}, potential, {}, net, maximum_clique);
 
-  std::vector<std::string> temp{maximum_clique.cbegin(), maximum_clique.cend()};
+  std::vector<std::string_view> temp{};
+  for (uint32_t node : maximum_clique) { temp.emplace_back(net.names.name(node)); }
   std::sort(temp.begin(), temp.end());
   std::string password{};
-  for (int i = 0; i < temp.size(); ++i) {
+  for (std::size_t i = 0; i < temp.size(); ++i) {
     password += temp[i];
     if (i != temp.size() - 1) { password += ','; }
   }
 
-  assert("af,aq,ck,ee,fb,it,kg,of,ol,rt,sc,vk,zh" == password);
-  std::cout << "Part 2: What is the password to get into the LAN party? " << password << '\n';
+  return password;
+}
+
+[[maybe_unused]] helper::solution solve(std::string_view input) {
+  auto net = parse_input(input);
+  return {std::to_string(solve_part1(net)), solve_part2(net)};
 }
 
+} // namespace
+
+#if defined(AOC_DRIVER)
+helper::register_day const registration{23, solve};
+#else
 int main() {
-  auto graph = build_graph(parse_input());
-  solve_part1(graph);
-  solve_part2(graph);
+  helper::mapped_file const file{"input.txt", helper::mapped_file::access_hint::sequential};
+  helper::benchmark bench{};
+
+  auto net = bench.run("parse_input", [&] { return parse_input(file.view()); });
+
+  int count = bench.run("solve_part1", [&] { return solve_part1(net); });
+  assert(1419 == count);
+  std::cout << "Part 1: How many contain at least one computer with a name that starts with t? " << count << '\n';
+
+  std::string password = bench.run("bron_kerbosch", [&] { return solve_part2(net, bron_kerbosch); });
+  assert("af,aq,ck,ee,fb,it,kg,of,ol,rt,sc,vk,zh" == password);
+  std::cout << "Part 2: What is the password to get into the LAN party? " << password << '\n';
+
+  if (bench.run_variants()) {
+    [[maybe_unused]] std::string no_pivot_password = bench.run("bron_kerbosch_no_pivot", [&] {
+      return solve_part2(net, bron_kerbosch_no_pivot);
+    });
+    assert(no_pivot_password == password);
+  }
+
+  bench.report();
 }
+#endif
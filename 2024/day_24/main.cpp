@@ -2,14 +2,11 @@
 //
 // clang++ -std=gnu++20 -stdlib=libc++ main.cpp -o main && ./main && rm main
 
-#include <fstream>
 #include <string>
-#include <unordered_map>
-#include <unordered_set>
-#include <regex>
-#include <tuple>
+#include <string_view>
 #include <vector>
 #include <algorithm>
+#include <numeric>
 #include <stdexcept>
 #include <cstdint>
 #include <cctype>
@@ -18,170 +15,121 @@
 
 #include "../aoc.h"
 
-auto parse_input() {
-  std::regex const sec1_pat(R"((\w+)\s*:\s*(0|1))");
-  std::regex const sec2_pat(R"((\w+)\s+(AND|OR|XOR)\s+(\w+)\s*->\s*(\w+))");
-
-  std::ifstream ifs(helper::read_file_as_stream("input.txt"));
-  std::string line{};
-  std::smatch match{};
+namespace {
+
+enum class opcode : uint8_t { none, AND, OR, XOR };
+
+struct gate {
+  opcode op = opcode::none;
+  uint32_t lhs = 0;
+  uint32_t rhs = 0;
+};
+
+// Wires are interned to dense ids. `values[id]` is the wire's signal, or -1
+// until it is known, and `gates[id]` is the gate driving it, if any.
+struct circuit {
+  helper::Interner names{};
+  std::vector<int> values{};
+  std::vector<gate> gates{};
+};
+
+using initial_value_line = helper::pattern<R"((\w+)\s*:\s*(0|1))">;
+using gate_line = helper::pattern<R"((\w+)\s+(AND|OR|XOR)\s+(\w+)\s*->\s*(\w+))">;
+
+circuit parse_input(std::string_view input) {
+  circuit c{};
+  auto wire = [&c](std::string_view name) {
+    uint32_t const id = c.names.intern(name);
+    if (id == c.values.size()) {
+      c.values.emplace_back(-1);
+      c.gates.emplace_back();
+    }
+    return id;
+  };
 
-  std::unordered_map<std::string, int> wires{};
-  std::unordered_map<std::string, std::tuple<std::string, std::string, std::string>> gates{};
-  while (std::getline(ifs, line)) {
+  while (!input.empty()) {
+    std::string_view const line = helper::pop_line(input);
     if (line.empty()) { continue; }
-    if (std::regex_match(line, match, sec1_pat)) {
-      wires.emplace(match[1], std::stoi(match[2]));
-    } else if (std::regex_match(line, match, sec2_pat)) {
-      gates.emplace(match[4], std::make_tuple(match[2], match[1], match[3]));
+    if (auto const match = initial_value_line::match(line)) {
+      c.values[wire((*match)[1])] = (*match)[2][0] - '0';
+    } else if (auto const match = gate_line::match(line)) {
+      auto const& [_, lhs_name, op_name, rhs_name, out_name] = *match;
+      opcode const op = op_name == "AND" ? opcode::AND : op_name == "OR" ? opcode::OR : opcode::XOR;
+      uint32_t const lhs = wire(lhs_name);
+      uint32_t const rhs = wire(rhs_name);
+      c.gates[wire(out_name)] = {op, lhs, rhs};
     }
   }
 
-  return std::make_pair(wires, gates);
+  return c;
 }
 
-int calc_wire_val(std::string const& wire_name,
-                  std::unordered_map<std::string, int>& wires,
-                  std::unordered_map<std::string, std::tuple<std::string, std::string, std::string>> const& gates) {
-  if (wires.contains(wire_name)) {
-    return wires.at(wire_name);
+int calc_wire_val(uint32_t wire, std::vector<int>& values, std::vector<gate> const& gates) {
+  AOC_COUNT("calc_wire_val.calls");
+  if (values[wire] != -1) {
+    return values[wire];
   }
 
-  auto const& [opcode, lhs, rhs] = gates.at(wire_name);
-  if (!wires.contains(lhs)) {
-    wires.emplace(lhs, calc_wire_val(lhs, wires, gates));
+  auto const& [op, lhs, rhs] = gates[wire];
+  if (values[lhs] == -1) {
+    values[lhs] = calc_wire_val(lhs, values, gates);
   }
-  if (!wires.contains(rhs)) {
-    wires.emplace(rhs, calc_wire_val(rhs, wires, gates));
+  if (values[rhs] == -1) {
+    values[rhs] = calc_wire_val(rhs, values, gates);
   }
 
+  AOC_COUNT("calc_wire_val.evaluations");
   int val;
-  if (opcode == "AND") {
-    val = wires[lhs] & wires[rhs];
-  } else if (opcode == "OR") {
-    val = wires[lhs] | wires[rhs];
-  } else if (opcode == "XOR") {
-    val = wires[lhs] ^ wires[rhs];
-  } else {
-    throw std::runtime_error("Unknown opcode: " + opcode);
+  switch (op) {
+    case opcode::AND: val = values[lhs] & values[rhs]; break;
+    case opcode::OR: val = values[lhs] | values[rhs]; break;
+    case opcode::XOR: val = values[lhs] ^ values[rhs]; break;
+    default: throw std::runtime_error("No gate drives wire " + std::to_string(wire));
   }
-  wires[wire_name] = val;
+  values[wire] = val;
   return val;
 }
 
-void solve_part1(std::unordered_map<std::string, int> wires,
-                 std::unordered_map<std::string, std::tuple<std::string, std::string, std::string>> const& gates) {
-  std::vector<std::pair<std::string, int>> z_wires{};
-  for (auto const& [out, _] : gates) {
-    if (out.size() >= 2 && out[0] == 'z' && std::isdigit(out[1])) {
-      z_wires.emplace_back(out, -1);
-    }
-  }
-  std::sort(z_wires.begin(), z_wires.end(), [](auto const& a, auto const& b) {
-    return a.first < b.first;
-  });
+uint64_t solve_part1(circuit const& c) {
+  std::vector<int> values{c.values};
 
-  for (auto& [name, val] : z_wires) {
-    val = calc_wire_val(name, wires, gates);
+  // (bit, wire) for every gate output named `z<bit>`.
+  std::vector<std::pair<int, uint32_t>> z_wires{};
+  for (uint32_t wire = 0; wire < c.names.size(); ++wire) {
+    std::string_view const name = c.names.name(wire);
+    if (c.gates[wire].op != opcode::none && name.size() >= 2 && name[0] == 'z' && std::isdigit(name[1])) {
+      z_wires.emplace_back(std::stoi(std::string{name.substr(1)}), wire);
+    }
   }
+  std::sort(z_wires.begin(), z_wires.end());
 
-  uint64_t dec_z = std::reduce(z_wires.crbegin(), z_wires.crend(), uint64_t{0}, [](uint64_t acc, auto const& wire) {
-    return acc * 2 + wire.second;
+  uint64_t dec_z = std::accumulate(z_wires.crbegin(), z_wires.crend(), uint64_t{0}, [&](uint64_t acc, auto const& z) {
+    return acc * 2 + calc_wire_val(z.second, values, c.gates);
   });
 
-  assert(53325321422566 == dec_z);
-  std::cout << "Part 1: What decimal number does it output on the wires starting with z? " << dec_z << '\n';
-}
-
-// https://en.wikipedia.org/wiki/Double_factorial
-constexpr uint64_t semifactorial(uint64_t n) {
-  if (n == 0 || n == 1) { return 1; }
-
-  uint64_t res = 1;
-  do {
-    res *= n;
-    n -= 2;
-  } while (n > 1);
-  return res;
-}
-
-// C(n, 2m) * ((2m - 1)!!)
-//
-// For n = 222, m = 4, the result is 13523504751481725, which is very large.
-constexpr uint64_t calc_num_of_unique_pairs(uint64_t n, uint64_t m) {
-  if (n < m * 2) {
-    throw std::invalid_argument("`n` must be greater than or equal to 2m");
-  }
-
-  uint64_t k = std::min(m * 2, n - m * 2);
-  uint64_t p = 1;
-  uint64_t q = 1;
-  for (int i = 0; i < k; ++i) {
-    p *= n - i;
-    q *= i + 1;
-  }
-
-  return (p / q) * semifactorial(m * 2 - 1);;
+  return dec_z;
 }
 
-template<typename Callback>
-void find_all_pairs(std::vector<std::pair<std::string, std::string>>& curr_pairs,
-                    std::vector<bool>& used,
-                    std::vector<std::string> const& elements,
-                    int m,
-                    int start_idx,
-                    Callback const& callback) {
-  if (curr_pairs.size() == m) {
-    callback(curr_pairs);
-    return;
-  }
-
-  for (int i = start_idx; i < elements.size(); ++i) {
-    if (used[i]) { continue; }
-
-    for (int j = i + 1; j < elements.size(); ++j) {
-      if (used[j]) { continue; }
-
-      curr_pairs.emplace_back(elements[i], elements[j]);
-      used[i] = used[j] = true;
-
-      find_all_pairs(curr_pairs, used, elements, m, i + 1, callback);
-
-      curr_pairs.pop_back();
-      used[i] = used[j] = false;
-    }
-  }
+// Part 2 is not solved.
+[[maybe_unused]] helper::solution solve(std::string_view input) {
+  return {std::to_string(solve_part1(parse_input(input))), ""};
 }
 
-template<typename Callback>
-void traverse_all_pairs(std::unordered_set<std::string> const& elements_set, int m, Callback const& callback) {
-  if (elements_set.size() < 2 * m) { return; }
-
-  std::vector<std::string> elements{elements_set.cbegin(), elements_set.cend()};
-  std::sort(elements.begin(), elements.end());
-
-  std::vector<bool> used(elements.size(), false);
-  std::vector<std::pair<std::string, std::string>> curr_pairs{};
-  find_all_pairs(curr_pairs, used, elements, m, 0, callback);
-}
+} // namespace
 
+#if defined(AOC_DRIVER)
+helper::register_day const registration{24, solve};
+#else
 int main() {
-  auto [wires, gates] = parse_input();
-  solve_part1(wires, gates);
+  helper::mapped_file const file{"input.txt", helper::mapped_file::access_hint::sequential};
+  helper::benchmark bench{};
 
-  // Debug: It's impossible to swap back and check all possible 4-pair gates.
-  {
-    std::cout << calc_num_of_unique_pairs(gates.size(), 4) << '\n';
+  auto c = bench.run("parse_input", [&] { return parse_input(file.view()); });
 
-    std::unordered_set<std::string> all_gate_outputs{};
-    all_gate_outputs.reserve(gates.size());
-    for (auto const& [output, _] : gates) {
-      all_gate_outputs.emplace(output);
-    }
-    int count = 0;
-    traverse_all_pairs(all_gate_outputs, 4, [&count] (std::vector<std::pair<std::string, std::string>> const& pairs) {
-      ++count;
-      std::cout << count << '\n';
-    });
-  }
+  uint64_t dec_z = bench.run("solve_part1", [&] { return solve_part1(c); });
+  assert(53325321422566 == dec_z);
+  std::cout << "Part 1: What decimal number does it output on the wires starting with z? " << dec_z << '\n';
+
+  bench.report();
 }
+#endif
@@ -2,31 +2,34 @@
 //
 // clang++ -std=gnu++20 -stdlib=libc++ main.cpp -o main && ./main && rm main
 
-#include <fstream>
+#include <string>
+#include <string_view>
 #include <utility>
-#include <vector>
+#include <span>
 #include <iterator>
 #include <algorithm>
 #include <set>
+#include <vector>
+#include <functional>
 #include <cstdint>
 #include <cassert>
 #include <iostream>
 
 #include "../aoc.h"
 
-std::pair<std::vector<std::vector<int>>, std::vector<std::vector<int>>> parse_input() {
-  std::ifstream ifs{helper::read_file_as_stream("input.txt")};
+namespace {
 
+std::pair<helper::Jagged<int>, helper::Jagged<int>> parse_input(std::string_view input) {
   // `locks` and `keys` will store their respective schematic representations.
-  // Each vector's first element represents the maximum height of the schematic.
-  std::vector<std::vector<int>> locks{};
-  std::vector<std::vector<int>> keys{};
+  // Each row's first element represents the maximum height of the schematic.
+  helper::Jagged<int> locks{};
+  helper::Jagged<int> keys{};
 
-  std::string line{};
   bool is_lock = false;
   int schematic_row_index = 0;
 
-  while (std::getline(ifs, line)) {
+  while (!input.empty()) {
+    std::string_view line = helper::pop_line(input);
     if (line.empty()) {
       schematic_row_index = 0;
       continue;
@@ -34,11 +37,15 @@ std::pair<std::vector<std::vector<int>>, std::vector<std::vector<int>>> parse_in
 
     if (schematic_row_index == 0) {
       is_lock = line[0] == '#';
-      (is_lock ? locks : keys).emplace_back(line.size() + 1, is_lock ? 0 : -1);
+      auto& target = is_lock ? locks : keys;
+      target.start_row();
+      for (std::size_t i = 0; i <= line.size(); ++i) {
+        target.push_back(is_lock ? 0 : -1);
+      }
     } else {
-      auto& target = is_lock ? locks.back() : keys.back();
+      auto target = is_lock ? locks.back() : keys.back();
       target[0] = schematic_row_index - 1; // Update the maximum height
-      std::transform(line.cbegin(), line.cend(), std::next(target.cbegin()), std::next(target.begin()), [](char c, int i) {
+      std::transform(line.cbegin(), line.cend(), std::next(target.begin()), std::next(target.begin()), [](char c, int i) {
         return i + (c == '#' ? 1 : 0);
       });
     }
@@ -49,31 +56,58 @@ std::pair<std::vector<std::vector<int>>, std::vector<std::vector<int>>> parse_in
   return {locks, keys};
 }
 
-void solve_part1(std::vector<std::vector<int>> const& locks, std::vector<std::vector<int>> const& keys) {
-  std::set<std::vector<int>> unique_locks{locks.cbegin(), locks.cend()};
-  std::set<std::vector<int>> unique_keys{keys.cbegin(), keys.cend()};
+struct lexicographical_less {
+  bool operator()(std::span<int const> lhs, std::span<int const> rhs) const {
+    return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+  }
+};
+
+// Each unique lock is checked against every unique key; locks are split
+// across threads.
+uint64_t solve_part1(helper::Jagged<int> const& locks, helper::Jagged<int> const& keys) {
+  std::set<std::span<int const>, lexicographical_less> const lock_set{locks.begin(), locks.end()};
+  std::set<std::span<int const>, lexicographical_less> const key_set{keys.begin(), keys.end()};
+  std::vector<std::span<int const>> const unique_locks{lock_set.begin(), lock_set.end()};
+  std::vector<std::span<int const>> const unique_keys{key_set.begin(), key_set.end()};
 
-  uint64_t unique_lock_key_pair_count = unique_locks.size() * unique_keys.size();
-  for (auto const& lock : unique_locks) {
+  return helper::thread_pool::global().parallel_reduce(0, unique_locks.size(), uint64_t{0}, [&](std::size_t l) {
+    auto const& lock = unique_locks[l];
+    uint64_t fitting = 0;
     for (auto const& key : unique_keys) {
       std::size_t width = std::min(lock.size(), key.size());
       int max_height = std::max(lock[0], key[0]);
 
-      for (std::size_t i = 1; i < width; ++i) {
-        if (lock[i] + key[i] > max_height) {
-          --unique_lock_key_pair_count;
-          break;
-        }
+      bool overlaps = false;
+      for (std::size_t i = 1; i < width && !overlaps; ++i) {
+        overlaps = lock[i] + key[i] > max_height;
       }
+      fitting += overlaps ? 0 : 1;
     }
-  }
+    return fitting;
+  }, std::plus<uint64_t>{});
+}
 
-  assert(3249 == unique_lock_key_pair_count);
-  std::cout << "Part 1: How many unique lock/key pairs fit together without overlapping in any column? " << unique_lock_key_pair_count << '\n';
+[[maybe_unused]] helper::solution solve(std::string_view input) {
+  auto [locks, keys] = parse_input(input);
+  return {std::to_string(solve_part1(locks, keys)), ""};
 }
 
+} // namespace
+
+#if defined(AOC_DRIVER)
+helper::register_day const registration{25, solve};
+#else
 int main() {
-  auto [locks, keys] = parse_input();
-  solve_part1(locks, keys);
+  helper::mapped_file const file{"input.txt", helper::mapped_file::access_hint::sequential};
+  helper::benchmark bench{};
+
+  auto [locks, keys] = bench.run("parse_input", [&] { return parse_input(file.view()); });
+
+  uint64_t unique_lock_key_pair_count = bench.run("solve_part1", [&] { return solve_part1(locks, keys); });
+  assert(3249 == unique_lock_key_pair_count);
+  std::cout << "Part 1: How many unique lock/key pairs fit together without overlapping in any column? " << unique_lock_key_pair_count << '\n';
   // No part2 to solve.
+
+  bench.report();
 }
+#endif
@@ -0,0 +1,223 @@
+// aoc2024: every day of 2024 linked into one binary.
+//
+// clang++ -std=gnu++20 -stdlib=libc++ -O2 -DAOC_DRIVER main.cpp ../day_*/main.cpp -o aoc2024 && ./aoc2024 --all && rm aoc2024
+//
+//   --day N       solve day N (repeatable, or a comma-separated list)
+//   --all         solve every linked day
+//   --input PATH  input for the single selected day (default: <root>/day_NN/input.txt)
+//   --root DIR    directory holding the day_NN folders (default: ..)
+//   --repeat N    solve each day N times and report min/median latency (default: 1)
+//   --threads N   threads in the shared pool (default: AOC_THREADS, else hardware concurrency)
+//
+// Selected days run concurrently on `helper::thread_pool::global()`, one day
+// per task, with each day's repeats run back to back. Answers go to stdout;
+// the latency table goes to stderr. A `-DAOC_ALLOC_STATS` build, whose
+// allocation counts are process-wide, accepts only one day per run.
+
+#define AOC_DRIVER_MAIN
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <map>
+#include <optional>
+#include <algorithm>
+#include <charconv>
+#include <system_error>
+#include <chrono>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+
+#include "../aoc.h"
+
+namespace {
+
+struct options {
+  std::vector<int> days{};
+  bool all = false;
+  std::string input{};
+  std::string root{".."};
+  int repeat = 1;
+  unsigned threads = 0;
+};
+
+struct day_result {
+  int day = 0;
+  helper::solution answers{};
+  std::vector<int64_t> samples_ns{};
+  std::string error{};
+};
+
+void print_usage(char const* prog) {
+  std::cerr << "usage: " << prog << " (--all | --day N [--day N ...]) [--input PATH] [--root DIR]"
+            << " [--repeat N] [--threads N]\n"
+            << "linked days:";
+  for (auto const& [day, _] : helper::registered_days()) {
+    std::cerr << ' ' << day;
+  }
+  std::cerr << '\n';
+}
+
+std::optional<options> parse_args(int argc, char* argv[]) {
+  options opts{};
+  for (int i = 1; i < argc; ++i) {
+    std::string_view const arg{argv[i]};
+    auto value = [&]() -> std::optional<std::string_view> {
+      if (i + 1 >= argc) {
+        std::cerr << arg << " needs a value\n";
+        return std::nullopt;
+      }
+      return argv[++i];
+    };
+    // The whole of `text` must be the number: `5x` or `4abc` is an error.
+    auto number = [&](std::string_view text) -> std::optional<int> {
+      int n = 0;
+      auto const [end, ec] = std::from_chars(text.data(), text.data() + text.size(), n);
+      if (ec != std::errc{} || end != text.data() + text.size() || n <= 0) {
+        std::cerr << arg << " needs a positive number, got `" << text << "`\n";
+        return std::nullopt;
+      }
+      return n;
+    };
+
+    if (arg == "--all") {
+      opts.all = true;
+    } else if (arg == "--day") {
+      auto list = value();
+      if (!list) { return std::nullopt; }
+      while (true) {
+        std::size_t const comma = list->find(',');
+        auto const day = number(list->substr(0, comma));
+        if (!day) { return std::nullopt; }
+        opts.days.emplace_back(*day);
+        if (comma == std::string_view::npos) { break; }
+        list->remove_prefix(comma + 1);
+      }
+    } else if (arg == "--input" || arg == "--root") {
+      auto const path = value();
+      if (!path) { return std::nullopt; }
+      (arg == "--input" ? opts.input : opts.root) = *path;
+    } else if (arg == "--repeat" || arg == "--threads") {
+      auto const text = value();
+      if (!text) { return std::nullopt; }
+      auto const n = number(*text);
+      if (!n) { return std::nullopt; }
+      if (arg == "--repeat") {
+        opts.repeat = *n;
+      } else {
+        opts.threads = *n;
+      }
+    } else {
+      std::cerr << "unknown argument `" << arg << "`\n";
+      return std::nullopt;
+    }
+  }
+
+  auto const& registered = helper::registered_days();
+  if (opts.all) {
+    opts.days.clear();
+    for (auto const& [day, _] : registered) { opts.days.emplace_back(day); }
+  }
+  std::sort(opts.days.begin(), opts.days.end());
+  opts.days.erase(std::unique(opts.days.begin(), opts.days.end()), opts.days.end());
+
+  if (opts.days.empty()) {
+    return std::nullopt;
+  }
+  for (int day : opts.days) {
+    if (!registered.contains(day)) {
+      std::cerr << "day " << day << " is not linked into this binary\n";
+      return std::nullopt;
+    }
+  }
+  if (!opts.input.empty() && opts.days.size() != 1) {
+    std::cerr << "--input needs exactly one day\n";
+    return std::nullopt;
+  }
+  // Allocation counts are process-wide, so concurrent days would pick up
+  // each other's allocations.
+  if (helper::alloc_stats::enabled && opts.days.size() != 1) {
+    std::cerr << "an AOC_ALLOC_STATS build can only run one day at a time\n";
+    return std::nullopt;
+  }
+
+  return opts;
+}
+
+std::string input_path(options const& opts, int day) {
+  if (!opts.input.empty()) { return opts.input; }
+  return opts.root + (day < 10 ? "/day_0" : "/day_") + std::to_string(day) + "/input.txt";
+}
+
+day_result run_day(options const& opts, int day) {
+  using clock = std::chrono::steady_clock;
+
+  day_result res{day};
+  try {
+    helper::mapped_file const file{input_path(opts, day), helper::mapped_file::access_hint::sequential};
+    helper::solver const solve = helper::registered_days().at(day);
+    for (int i = 0; i < opts.repeat; ++i) {
+      auto const start = clock::now();
+      res.answers = solve(file.view());
+      res.samples_ns.emplace_back(std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start).count());
+    }
+  } catch (std::exception const& e) {
+    res.error = e.what();
+  }
+  return res;
+}
+
+void report(std::vector<day_result> const& results, int64_t wall_ns) {
+  using helper::benchmark;
+
+  for (auto const& r : results) {
+    std::cout << "Day " << std::setw(2) << std::setfill('0') << r.day << std::setfill(' ');
+    if (!r.error.empty()) {
+      std::cout << ": error: " << r.error << '\n';
+      continue;
+    }
+    std::cout << ": " << (r.answers.part1.empty() ? "-" : r.answers.part1)
+              << " | " << (r.answers.part2.empty() ? "-" : r.answers.part2) << '\n';
+  }
+
+  int64_t busy_ns = 0;
+  std::cerr << std::left << std::setw(8) << "day" << std::right << std::setw(8) << "runs"
+            << std::setw(12) << "min" << std::setw(12) << "median" << '\n';
+  for (auto const& r : results) {
+    if (r.samples_ns.empty()) { continue; }
+    std::vector<int64_t> sorted{r.samples_ns};
+    std::sort(sorted.begin(), sorted.end());
+    for (int64_t ns : sorted) { busy_ns += ns; }
+    std::cerr << std::left << std::setw(8) << r.day << std::right << std::setw(8) << sorted.size()
+              << std::setw(12) << benchmark::format_ns(sorted.front())
+              << std::setw(12) << benchmark::format_ns(benchmark::percentile(sorted, 50)) << '\n';
+  }
+  std::cerr << "total: " << benchmark::format_ns(wall_ns) << " wall, "
+            << benchmark::format_ns(busy_ns) << " summed over days\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  auto const opts = parse_args(argc, argv);
+  if (!opts) {
+    print_usage(argv[0]);
+    return 1;
+  }
+
+  std::vector<day_result> results(opts->days.size());
+  auto const start = std::chrono::steady_clock::now();
+  // One task per day. Days that parallelize internally share the same pool,
+  // so a fast day's threads move on to help the slow ones.
+  helper::thread_pool::global(opts->threads).parallel_for(0, results.size(), [&](std::size_t i) {
+    results[i] = run_day(*opts, opts->days[i]);
+  }, 1);
+  auto const wall_ns =
+    std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+  report(results, wall_ns);
+
+  bool const failed = std::any_of(results.begin(), results.end(), [](auto const& r) { return !r.error.empty(); });
+  return failed ? 1 : 0;
+}
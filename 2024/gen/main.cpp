@@ -0,0 +1,812 @@
+// Synthetic input generator for the 2024 days.
+//
+// Every day's generator writes a valid puzzle input to stdout. Its defaults
+// match the size of the real puzzle input, and each size knob can be raised
+// with `key=value` arguments to produce inputs many times larger. The same
+// arguments and seed always give byte-identical output, on any platform and
+// standard library.
+//
+// clang++ -std=gnu++20 -stdlib=libc++ -O2 main.cpp -o gen && ./gen 06 rows=2000 cols=2000 seed=7 > input.txt && rm gen
+//
+// Run `./gen` without arguments to list the days and their knobs.
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <map>
+#include <unordered_set>
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <utility>
+#include <stdexcept>
+#include <iostream>
+
+namespace {
+
+using u64 = uint64_t;
+
+// `std::mt19937_64` is fully specified by the standard, but the standard
+// distributions and `std::shuffle` are not, so they're replaced here to keep
+// the output identical between libc++ and libstdc++.
+class rng {
+public:
+  explicit rng(u64 seed) : engine_{seed} {}
+
+  // Uniform integer in the closed range `[lo, hi]`.
+  int64_t between(int64_t lo, int64_t hi) {
+    u64 const span = static_cast<u64>(hi - lo) + 1;
+    if (span == 0) { return static_cast<int64_t>(engine_()); }
+    u64 const limit = UINT64_MAX - UINT64_MAX % span;
+    u64 x;
+    do { x = engine_(); } while (x >= limit);
+    return lo + static_cast<int64_t>(x % span);
+  }
+
+  // Uniform double in `[0, 1)`.
+  double unit() {
+    return static_cast<double>(engine_() >> 11) * 0x1.0p-53;
+  }
+
+  bool chance(double p) {
+    return unit() < p;
+  }
+
+  template<typename T>
+  T const& pick(std::vector<T> const& from) {
+    return from[between(0, from.size() - 1)];
+  }
+
+  template<typename T>
+  void shuffle(std::vector<T>& v) {
+    for (std::size_t i = v.size(); i > 1; --i) {
+      std::swap(v[i - 1], v[between(0, i - 1)]);
+    }
+  }
+
+private:
+  std::mt19937_64 engine_;
+};
+
+// `key=value` arguments. Every generator declares the keys it reads, along
+// with their defaults, so a misspelled key is reported instead of ignored.
+class options {
+public:
+  options(int argc, char* argv[]) {
+    for (int i = 0; i < argc; ++i) {
+      std::string_view const arg{argv[i]};
+      auto const eq = arg.find('=');
+      if (eq == std::string_view::npos || eq == 0) {
+        throw std::invalid_argument("expected key=value, got `" + std::string{arg} + "`");
+      }
+      values_.emplace(arg.substr(0, eq), arg.substr(eq + 1));
+    }
+  }
+
+  // Every integer knob is a count, size or seed, so negatives are rejected.
+  int64_t get_int(std::string const& key, int64_t fallback) {
+    known_.emplace(key);
+    auto const it = values_.find(key);
+    int64_t const value = it == values_.end() ? fallback : std::stoll(it->second);
+    if (value < 0) { throw std::invalid_argument("option `" + key + "` must not be negative"); }
+    return value;
+  }
+
+  double get_real(std::string const& key, double fallback) {
+    known_.emplace(key);
+    auto const it = values_.find(key);
+    return it == values_.end() ? fallback : std::stod(it->second);
+  }
+
+  void reject_unknown() const {
+    for (auto const& [key, _] : values_) {
+      if (!known_.contains(key)) {
+        throw std::invalid_argument("unknown option `" + key + "`");
+      }
+    }
+  }
+
+private:
+  std::map<std::string, std::string, std::less<>> values_;
+  std::unordered_set<std::string> known_;
+};
+
+// A lowercase name for `id` that never collides with another id of the same
+// `width`. With `first_letters`, the leading letter is restricted to that set.
+std::string base26_name(u64 id, int width, std::string_view first_letters = "abcdefghijklmnopqrstuvwxyz") {
+  std::string name(width, 'a');
+  for (int i = width - 1; i > 0; --i) {
+    name[i] = static_cast<char>('a' + id % 26);
+    id /= 26;
+  }
+  name[0] = first_letters[id % first_letters.size()];
+  return name;
+}
+
+// The shortest name width that gives `count` distinct names whose first letter
+// is one of `first_choices` letters.
+int name_width_for(u64 count, u64 first_choices = 26) {
+  int width = 1;
+  for (u64 capacity = first_choices; capacity < count; capacity *= 26) { ++width; }
+  return width;
+}
+
+std::string zero_padded(u64 n, int width) {
+  std::string s = std::to_string(n);
+  return std::string(std::max<int>(0, width - static_cast<int>(s.size())), '0') + s;
+}
+
+void write_grid(std::ostream& out, std::vector<std::string> const& grid) {
+  for (auto const& row : grid) {
+    out << row << '\n';
+  }
+}
+
+// `pairs` lines of two 5-digit location IDs. About a third of the right list
+// repeats IDs from the left list so the similarity score is not trivially zero.
+void gen_day_01(options& opts, rng& r, std::ostream& out) {
+  int64_t const pairs = opts.get_int("pairs", 1000);
+  opts.reject_unknown();
+
+  std::vector<int> left(pairs);
+  for (auto& id : left) { id = r.between(10000, 99999); }
+  for (int64_t i = 0; i < pairs; ++i) {
+    int const right = r.chance(0.35) ? r.pick(left) : r.between(10000, 99999);
+    out << left[i] << "   " << right << '\n';
+  }
+}
+
+// `reports` lines of `min_levels` to `max_levels` levels. `safe` of them
+// start out as safe monotonic sequences, and `damaged` of those then get one
+// level replaced.
+void gen_day_02(options& opts, rng& r, std::ostream& out) {
+  int64_t const reports = opts.get_int("reports", 1000);
+  double const safe = opts.get_real("safe", 0.5);
+  double const damaged = opts.get_real("damaged", 0.3);
+  int64_t const min_levels = opts.get_int("min_levels", 5);
+  int64_t const max_levels = opts.get_int("max_levels", 8);
+  opts.reject_unknown();
+
+  std::vector<int> levels{};
+  for (int64_t i = 0; i < reports; ++i) {
+    int const len = static_cast<int>(r.between(min_levels, max_levels));
+    levels.resize(len);
+    if (r.chance(safe)) {
+      int const dir = r.chance(0.5) ? 1 : -1;
+      // Long decreasing runs start high enough to stay positive.
+      levels[0] = dir > 0 ? r.between(1, 60) : r.between(30, 99) + 3 * (len - 1);
+      for (int j = 1; j < len; ++j) {
+        levels[j] = levels[j - 1] + dir * r.between(1, 3);
+      }
+      if (r.chance(damaged)) {
+        levels[r.between(0, len - 1)] = r.between(1, 99);
+      }
+    } else {
+      for (auto& level : levels) { level = r.between(1, 99); }
+    }
+
+    for (int j = 0; j < len; ++j) {
+      out << (j == 0 ? "" : " ") << levels[j];
+    }
+    out << '\n';
+  }
+}
+
+// About `bytes` bytes of corrupted memory: valid `mul(X,Y)` instructions,
+// near misses that must not match, `do()`/`don't()` toggles and filler.
+void gen_day_03(options& opts, rng& r, std::ostream& out) {
+  int64_t const bytes = opts.get_int("bytes", 18000);
+  int64_t const line_len = opts.get_int("line_len", 3000);
+  opts.reject_unknown();
+
+  std::vector<std::string> const filler{
+    "what()", "how()", "who()", "when()", "where()", "why()", "from()", "select()",
+    "'", "!", "@", "#", "$", "%", "^", "&", "*", "(", ")", "[", "]", "{", "}", "<", ">",
+    "?", "+", "-", ",", ":", ";", "~", " ", "/",
+  };
+  std::vector<std::string> const near_misses{
+    "mul(", "mul[", "mul ( ", "mul(,", "mul(4*", "mul(6,9!", "mul(1234,5)", "?(12,34)", "mul(32,64]", "do(", "don't",
+  };
+
+  std::string line{};
+  int64_t written = 0;
+  while (written < bytes) {
+    int64_t const roll = r.between(0, 99);
+    if (roll < 25) {
+      line += "mul(" + std::to_string(r.between(1, 999)) + ',' + std::to_string(r.between(1, 999)) + ')';
+    } else if (roll < 30) {
+      line += r.pick(near_misses);
+    } else if (roll < 32) {
+      line += r.chance(0.5) ? "do()" : "don't()";
+    } else {
+      line += r.pick(filler);
+    }
+
+    if (std::cmp_greater_equal(line.size(), line_len) || std::cmp_greater_equal(written + line.size(), bytes)) {
+      out << line << '\n';
+      written += line.size() + 1;
+      line.clear();
+    }
+  }
+  if (!line.empty()) { out << line << '\n'; }
+}
+
+// A `rows` x `cols` letter grid over `XMAS` with `plant` extra words written
+// along random directions.
+void gen_day_04(options& opts, rng& r, std::ostream& out) {
+  int64_t const rows = opts.get_int("rows", 140);
+  int64_t const cols = opts.get_int("cols", 140);
+  double const plant = opts.get_real("plant", 0.02);
+  opts.reject_unknown();
+
+  std::string_view constexpr letters = "XMAS";
+  std::vector<std::string> grid(rows, std::string(cols, 'X'));
+  for (auto& row : grid) {
+    for (auto& c : row) { c = letters[r.between(0, 3)]; }
+  }
+
+  int64_t const planted = static_cast<int64_t>(plant * rows * cols);
+  for (int64_t n = 0; n < planted; ++n) {
+    int const dr = r.between(-1, 1);
+    int const dc = r.between(-1, 1);
+    if (dr == 0 && dc == 0) { continue; }
+    int64_t const row = r.between(0, rows - 1);
+    int64_t const col = r.between(0, cols - 1);
+    if (row + 3 * dr < 0 || row + 3 * dr >= rows || col + 3 * dc < 0 || col + 3 * dc >= cols) { continue; }
+    for (int i = 0; i < 4; ++i) {
+      grid[row + i * dr][col + i * dc] = letters[i];
+    }
+  }
+
+  write_grid(out, grid);
+}
+
+// `pages` distinct page numbers under a hidden total order, with a rule for
+// every pair of them, then `updates` updates of odd length up to `max_len`.
+// About half the updates are already correctly ordered.
+void gen_day_05(options& opts, rng& r, std::ostream& out) {
+  int64_t const pages = opts.get_int("pages", 49);
+  int64_t const updates = opts.get_int("updates", 200);
+  int64_t const max_len = std::min(opts.get_int("max_len", 23), pages);
+  opts.reject_unknown();
+
+  // Page numbers are drawn from the smallest two-or-more-digit range that fits.
+  int64_t lo = 10;
+  while (lo * 9 < pages) { lo *= 10; }
+  std::vector<int64_t> order(lo * 9);
+  std::iota(order.begin(), order.end(), lo);
+  r.shuffle(order);
+  order.resize(pages);
+
+  std::vector<std::pair<int64_t, int64_t>> rules{};
+  rules.reserve(pages * (pages - 1) / 2);
+  for (int64_t i = 0; i < pages; ++i) {
+    for (int64_t j = i + 1; j < pages; ++j) {
+      rules.emplace_back(order[i], order[j]);
+    }
+  }
+  r.shuffle(rules);
+  for (auto const& [before, after] : rules) {
+    out << before << '|' << after << '\n';
+  }
+  out << '\n';
+
+  std::vector<int64_t> ranks(pages);
+  std::iota(ranks.begin(), ranks.end(), 0);
+  for (int64_t u = 0; u < updates; ++u) {
+    int64_t const len = r.between(2, (max_len + 1) / 2) * 2 - 1;
+    // A partial shuffle is enough to draw `len` distinct pages.
+    for (int64_t i = 0; i < len; ++i) {
+      std::swap(ranks[i], ranks[r.between(i, pages - 1)]);
+    }
+    std::vector<int64_t> update(ranks.begin(), ranks.begin() + len);
+    if (r.chance(0.5)) { std::sort(update.begin(), update.end()); }
+    for (int64_t i = 0; i < len; ++i) {
+      out << (i == 0 ? "" : ",") << order[update[i]];
+    }
+    out << '\n';
+  }
+}
+
+// A `rows` x `cols` lab map with obstacles at `density`, and a guard facing
+// up. Obstacles on any loop the guard would walk are removed until the guard
+// walks off the map, as the puzzle guarantees.
+void gen_day_06(options& opts, rng& r, std::ostream& out) {
+  int64_t const rows = opts.get_int("rows", 130);
+  int64_t const cols = opts.get_int("cols", 130);
+  double const density = opts.get_real("density", 0.048);
+  opts.reject_unknown();
+
+  std::vector<std::string> grid(rows, std::string(cols, '.'));
+  for (auto& row : grid) {
+    for (auto& c : row) { c = r.chance(density) ? '#' : '.'; }
+  }
+  int64_t const start_row = r.between(rows / 4, rows - 1 - rows / 4);
+  int64_t const start_col = r.between(cols / 4, cols - 1 - cols / 4);
+  grid[start_row][start_col] = '^';
+
+  constexpr int dr[4]{-1, 0, 1, 0};
+  constexpr int dc[4]{0, 1, 0, -1};
+  std::vector<uint8_t> seen(rows * cols);
+  for (;;) {
+    std::fill(seen.begin(), seen.end(), 0);
+    int64_t row = start_row;
+    int64_t col = start_col;
+    int dir = 0;
+    bool looped = false;
+    for (;;) {
+      uint8_t& state = seen[row * cols + col];
+      if (state & (1 << dir)) {
+        looped = true;
+        break;
+      }
+      state |= 1 << dir;
+
+      int64_t const next_row = row + dr[dir];
+      int64_t const next_col = col + dc[dir];
+      if (next_row < 0 || next_row >= rows || next_col < 0 || next_col >= cols) { break; }
+      if (grid[next_row][next_col] == '#') {
+        dir = (dir + 1) % 4;
+      } else {
+        row = next_row;
+        col = next_col;
+      }
+    }
+    if (!looped) { break; }
+
+    // The guard is back at a state it has been in before, so the next
+    // obstacle it turns at is on the loop. Removing it breaks the loop.
+    while (grid[row + dr[dir]][col + dc[dir]] != '#') {
+      row += dr[dir];
+      col += dc[dir];
+    }
+    grid[row + dr[dir]][col + dc[dir]] = '.';
+  }
+
+  write_grid(out, grid);
+}
+
+// `equations` calibration equations with 2 to `max_operands` operands. About
+// a third are solvable with `+` and `*`, a third also need `||`, and the rest
+// are off by one from a solvable target.
+void gen_day_07(options& opts, rng& r, std::ostream& out) {
+  int64_t const equations = opts.get_int("equations", 850);
+  int64_t const max_operands = opts.get_int("max_operands", 12);
+  opts.reject_unknown();
+
+  // Targets stay below this, well clear of `u64` overflow in the solvers.
+  constexpr u64 max_target = 1'000'000'000'000'000;
+
+  std::vector<u64> operands{};
+  for (int64_t eq = 0; eq < equations;) {
+    int64_t const count = r.between(2, max_operands);
+    operands.resize(count);
+    for (auto& operand : operands) {
+      operand = r.chance(0.7) ? r.between(1, 9) : r.between(10, 999);
+    }
+
+    int64_t const kind = r.between(0, 2);
+    u64 target = operands[0];
+    bool overflow = false;
+    for (int64_t i = 1; i < count && !overflow; ++i) {
+      int const op = r.between(0, kind == 0 ? 1 : 2);
+      u64 const rhs = operands[i];
+      if (op == 0) {
+        target += rhs;
+      } else if (op == 1) {
+        overflow = target > max_target / rhs;
+        target *= rhs;
+      } else {
+        u64 scale = 10;
+        while (scale <= rhs) { scale *= 10; }
+        overflow = target > max_target / scale;
+        target = target * scale + rhs;
+      }
+      overflow = overflow || target > max_target;
+    }
+    if (overflow) { continue; }
+    if (kind == 2) { ++target; }
+
+    out << target << ':';
+    for (u64 operand : operands) { out << ' ' << operand; }
+    out << '\n';
+    ++eq;
+  }
+}
+
+// A `rows` x `cols` roof map with `frequencies` antenna frequencies of 3 to 5
+// antennas each.
+void gen_day_08(options& opts, rng& r, std::ostream& out) {
+  int64_t const rows = opts.get_int("rows", 50);
+  int64_t const cols = opts.get_int("cols", 50);
+  int64_t const frequencies = std::min<int64_t>(opts.get_int("frequencies", 44), 62);
+  opts.reject_unknown();
+
+  std::string_view constexpr symbols = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz";
+  std::vector<std::string> grid(rows, std::string(cols, '.'));
+  int64_t const free_cells = rows * cols;
+  for (int64_t f = 0; f < frequencies; ++f) {
+    int64_t const antennas = r.between(3, 5);
+    for (int64_t a = 0, tries = 0; a < antennas && tries < free_cells; ++tries) {
+      char& cell = grid[r.between(0, rows - 1)][r.between(0, cols - 1)];
+      if (cell != '.') { continue; }
+      cell = symbols[f];
+      ++a;
+    }
+  }
+
+  write_grid(out, grid);
+}
+
+// A disk map of `length` digits: file lengths 1-9 alternating with free-space
+// lengths 0-9, starting and ending with a file.
+void gen_day_09(options& opts, rng& r, std::ostream& out) {
+  int64_t length = opts.get_int("length", 19999);
+  opts.reject_unknown();
+  if (length % 2 == 0) { ++length; }
+
+  std::string disk_map(length, '0');
+  for (int64_t i = 0; i < length; ++i) {
+    disk_map[i] = static_cast<char>('0' + (i % 2 == 0 ? r.between(1, 9) : r.between(0, 9)));
+  }
+  out << disk_map << '\n';
+}
+
+// A `rows` x `cols` topographic map made of `peaks` cone-shaped hills: each
+// cell within 9 steps of its nearest summit is 9 minus that distance, so every
+// slope is a hiking trail. Other cells, and a `noise` share of all cells, get
+// random heights.
+void gen_day_10(options& opts, rng& r, std::ostream& out) {
+  int64_t const rows = opts.get_int("rows", 47);
+  int64_t const cols = opts.get_int("cols", 47);
+  int64_t const peaks = opts.get_int("peaks", rows * cols / 100 + 1);
+  double const noise = opts.get_real("noise", 0.1);
+  opts.reject_unknown();
+
+  // Multi-source BFS from the summits gives each cell its distance to the
+  // nearest one.
+  std::vector<int> dist(rows * cols, -1);
+  std::vector<int64_t> queue{};
+  for (int64_t p = 0; p < peaks; ++p) {
+    int64_t const cell = r.between(0, rows * cols - 1);
+    if (dist[cell] == 0) { continue; }
+    dist[cell] = 0;
+    queue.emplace_back(cell);
+  }
+  for (std::size_t head = 0; head < queue.size(); ++head) {
+    int64_t const cell = queue[head];
+    if (dist[cell] == 9) { continue; }
+    int64_t const row = cell / cols;
+    int64_t const col = cell % cols;
+    auto visit = [&](int64_t next) {
+      if (dist[next] != -1) { return; }
+      dist[next] = dist[cell] + 1;
+      queue.emplace_back(next);
+    };
+    if (row > 0) { visit(cell - cols); }
+    if (row + 1 < rows) { visit(cell + cols); }
+    if (col > 0) { visit(cell - 1); }
+    if (col + 1 < cols) { visit(cell + 1); }
+  }
+
+  std::vector<std::string> grid(rows, std::string(cols, '0'));
+  for (int64_t cell = 0; cell < rows * cols; ++cell) {
+    bool const random = dist[cell] == -1 || r.chance(noise);
+    grid[cell / cols][cell % cols] = static_cast<char>('0' + (random ? r.between(0, 9) : 9 - dist[cell]));
+  }
+
+  write_grid(out, grid);
+}
+
+// Register A drawn with `bits` significant bits, for the puzzle's program.
+// day_17's part 2 is hand-compiled for that program, so only A varies.
+void gen_day_17(options& opts, rng& r, std::ostream& out) {
+  int64_t const bits = std::clamp<int64_t>(opts.get_int("bits", 48), 1, 63);
+  opts.reject_unknown();
+
+  u64 const a = (u64{1} << (bits - 1)) | static_cast<u64>(r.between(0, (int64_t{1} << (bits - 1)) - 1));
+  out << "Register A: " << a << '\n'
+      << "Register B: 0\n"
+      << "Register C: 0\n"
+      << '\n'
+      << "Program: 2,4,1,2,7,5,4,5,1,3,5,5,0,3,3,0\n";
+}
+
+// `patterns` distinct towel patterns of 1 to 8 stripes, and `designs` designs
+// of 20 to 60 stripes. `possible` of the designs are built from the patterns;
+// the rest can't be.
+//
+// Random designs would nearly always decompose into that many patterns, so
+// `r` is held back: no pattern starts or ends with it or has two in a row.
+// Two adjacent `r`s in a design then can't sit inside one pattern or across
+// the boundary of two, so an impossible design is random stripes with `rr`
+// written somewhere into them.
+void gen_day_19(options& opts, rng& r, std::ostream& out) {
+  int64_t const patterns = opts.get_int("patterns", 447);
+  int64_t const designs = opts.get_int("designs", 400);
+  double const possible = opts.get_real("possible", 0.6);
+  opts.reject_unknown();
+
+  std::string_view constexpr colors = "wubrg";
+  auto random_stripes = [&](int64_t len) {
+    std::string s(len, 'w');
+    for (auto& c : s) { c = colors[r.between(0, 4)]; }
+    return s;
+  };
+
+  // Only 263460 patterns of up to 8 stripes follow the `r` rules.
+  int64_t const count = std::min<int64_t>(patterns, 263460);
+  std::unordered_set<std::string> seen{};
+  std::vector<std::string> towels{};
+  while (std::cmp_less(towels.size(), count)) {
+    std::string towel = random_stripes(r.between(1, 8));
+    if (towel.front() == 'r' || towel.back() == 'r' || towel.find("rr") != std::string::npos) { continue; }
+    if (seen.emplace(towel).second) { towels.emplace_back(std::move(towel)); }
+  }
+  for (std::size_t i = 0; i < towels.size(); ++i) {
+    out << (i == 0 ? "" : ", ") << towels[i];
+  }
+  out << "\n\n";
+
+  for (int64_t d = 0; d < designs; ++d) {
+    int64_t const len = r.between(20, 60);
+    std::string design{};
+    if (r.chance(possible)) {
+      while (std::cmp_less(design.size(), len)) { design += r.pick(towels); }
+    } else {
+      design = random_stripes(len);
+      design.replace(r.between(0, len - 2), 2, "rr");
+    }
+    out << design << '\n';
+  }
+}
+
+// A `rows` x `cols` racetrack with a single path from S to E and walls
+// everywhere else. The track is the longest path of a random maze carved on
+// the odd cells, so it winds back on itself and leaves room for cheats.
+void gen_day_20(options& opts, rng& r, std::ostream& out) {
+  int64_t const rows = opts.get_int("rows", 141) | 1;
+  int64_t const cols = opts.get_int("cols", 141) | 1;
+  opts.reject_unknown();
+  if (rows < 5 || cols < 5) { throw std::invalid_argument("the racetrack needs at least 5 rows and 5 columns"); }
+
+  // Maze cells are the odd (row, col) positions; `parent` links form a
+  // spanning tree grown by randomized depth-first search.
+  int64_t const maze_rows = rows / 2;
+  int64_t const maze_cols = cols / 2;
+  int64_t const cells = maze_rows * maze_cols;
+  std::vector<int64_t> parent(cells, -1);
+  std::vector<int64_t> depth(cells, 0);
+  std::vector<uint8_t> visited(cells, 0);
+  std::vector<int64_t> stack{0};
+  visited[0] = 1;
+  while (!stack.empty()) {
+    int64_t const cell = stack.back();
+    int64_t const row = cell / maze_cols;
+    int64_t const col = cell % maze_cols;
+    int64_t candidates[4];
+    int n = 0;
+    if (row > 0 && !visited[cell - maze_cols]) { candidates[n++] = cell - maze_cols; }
+    if (row + 1 < maze_rows && !visited[cell + maze_cols]) { candidates[n++] = cell + maze_cols; }
+    if (col > 0 && !visited[cell - 1]) { candidates[n++] = cell - 1; }
+    if (col + 1 < maze_cols && !visited[cell + 1]) { candidates[n++] = cell + 1; }
+    if (n == 0) {
+      stack.pop_back();
+      continue;
+    }
+    int64_t const next = candidates[r.between(0, n - 1)];
+    visited[next] = 1;
+    parent[next] = cell;
+    depth[next] = depth[cell] + 1;
+    stack.emplace_back(next);
+  }
+
+  // The deepest cell of the tree ends the track.
+  int64_t const end = std::max_element(depth.begin(), depth.end()) - depth.begin();
+
+  std::vector<std::string> grid(rows, std::string(cols, '#'));
+  auto at = [&](int64_t cell) -> char& { return grid[cell / maze_cols * 2 + 1][cell % maze_cols * 2 + 1]; };
+  for (int64_t cell = end; parent[cell] != -1; cell = parent[cell]) {
+    int64_t const p = parent[cell];
+    at(cell) = '.';
+    grid[cell / maze_cols + p / maze_cols + 1][cell % maze_cols + p % maze_cols + 1] = '.';
+  }
+  at(0) = 'S';
+  at(end) = 'E';
+
+  write_grid(out, grid);
+}
+
+// An undirected graph of `nodes` computers where each has about `degree`
+// links, with a clique of `clique` computers planted in it. Names are two
+// lowercase letters like the puzzle's, widening once they run out.
+void gen_day_23(options& opts, rng& r, std::ostream& out) {
+  int64_t const nodes = opts.get_int("nodes", 520);
+  int64_t const degree = opts.get_int("degree", 13);
+  int64_t const clique = std::min(opts.get_int("clique", 13), nodes);
+  opts.reject_unknown();
+
+  int const width = std::max(2, name_width_for(nodes));
+  std::vector<u64> ids(nodes);
+  {
+    // Scatter the ids over the whole name space so names are not sequential.
+    u64 capacity = 26;
+    for (int i = 1; i < width; ++i) { capacity *= 26; }
+    std::unordered_set<u64> used{};
+    for (auto& id : ids) {
+      do { id = r.between(0, capacity - 1); } while (!used.emplace(id).second);
+    }
+  }
+
+  std::unordered_set<u64> edges{};
+  std::vector<std::pair<int64_t, int64_t>> edge_list{};
+  auto add_edge = [&](int64_t a, int64_t b) {
+    if (a == b) { return; }
+    if (a > b) { std::swap(a, b); }
+    if (edges.emplace(static_cast<u64>(a) * nodes + b).second) { edge_list.emplace_back(a, b); }
+  };
+
+  for (int64_t a = 0; a < clique; ++a) {
+    for (int64_t b = a + 1; b < clique; ++b) { add_edge(a, b); }
+  }
+  int64_t const random_edges = nodes * degree / 2;
+  for (int64_t e = 0; e < random_edges; ++e) {
+    add_edge(r.between(0, nodes - 1), r.between(0, nodes - 1));
+  }
+
+  r.shuffle(edge_list);
+  for (auto [a, b] : edge_list) {
+    if (r.chance(0.5)) { std::swap(a, b); }
+    out << base26_name(ids[a], width) << '-' << base26_name(ids[b], width) << '\n';
+  }
+}
+
+// A `bits`-bit ripple-carry adder with random inputs, in gate-per-line form,
+// with the outputs of `swaps` random gate pairs swapped like the puzzle's.
+void gen_day_24(options& opts, rng& r, std::ostream& out) {
+  int64_t const bits = std::max<int64_t>(opts.get_int("bits", 45), 2);
+  int64_t const swaps = opts.get_int("swaps", 4);
+  opts.reject_unknown();
+
+  // z wires are compared as strings, so every index gets the same width.
+  int const index_width = std::max(2, static_cast<int>(std::to_string(bits).size()));
+  auto io_name = [&](char prefix, int64_t i) { return prefix + zero_padded(i, index_width); };
+
+  for (char prefix : {'x', 'y'}) {
+    for (int64_t i = 0; i < bits; ++i) {
+      out << io_name(prefix, i) << ": " << r.between(0, 1) << '\n';
+    }
+  }
+  out << '\n';
+
+  // Internal wires never start with x, y or z.
+  std::string_view constexpr internal_first = "abcdefghijklmnopqrstuvw";
+  int const width = std::max(3, name_width_for(bits * 5, internal_first.size()));
+  u64 next_internal = 0;
+  auto internal_name = [&] { return base26_name(next_internal++ * 7919 + 13, width, internal_first); };
+
+  struct gate { std::string lhs, op, rhs, out; };
+  std::vector<gate> gates{};
+  gates.push_back({io_name('x', 0), "XOR", io_name('y', 0), io_name('z', 0)});
+  std::string carry = internal_name();
+  gates.push_back({io_name('x', 0), "AND", io_name('y', 0), carry});
+  for (int64_t i = 1; i < bits; ++i) {
+    std::string const half_sum = internal_name();
+    std::string const half_carry = internal_name();
+    std::string const carry_through = internal_name();
+    std::string const next_carry = i + 1 == bits ? io_name('z', bits) : internal_name();
+    gates.push_back({io_name('x', i), "XOR", io_name('y', i), half_sum});
+    gates.push_back({io_name('x', i), "AND", io_name('y', i), half_carry});
+    gates.push_back({half_sum, "XOR", carry, io_name('z', i)});
+    gates.push_back({half_sum, "AND", carry, carry_through});
+    gates.push_back({half_carry, "OR", carry_through, next_carry});
+    carry = next_carry;
+  }
+
+  // Swapping two outputs can create a cycle, so only gates reading `x`/`y`
+  // directly are exchanged: they depend on nothing but inputs either way.
+  std::vector<std::size_t> input_gates{};
+  for (std::size_t g = 0; g < gates.size(); ++g) {
+    if (gates[g].lhs[0] == 'x') { input_gates.emplace_back(g); }
+  }
+  r.shuffle(input_gates);
+  for (int64_t s = 0; s < swaps && std::cmp_less(2 * s + 1, input_gates.size()); ++s) {
+    std::swap(gates[input_gates[2 * s]].out, gates[input_gates[2 * s + 1]].out);
+  }
+
+  r.shuffle(gates);
+  for (auto const& g : gates) {
+    bool const flip = r.chance(0.5);
+    out << (flip ? g.rhs : g.lhs) << ' ' << g.op << ' ' << (flip ? g.lhs : g.rhs) << " -> " << g.out << '\n';
+  }
+}
+
+// `locks` locks and `keys` keys as 7-row by 5-column schematics.
+void gen_day_25(options& opts, rng& r, std::ostream& out) {
+  int64_t const locks = opts.get_int("locks", 250);
+  int64_t const keys = opts.get_int("keys", 250);
+  opts.reject_unknown();
+
+  std::vector<bool> kinds(locks + keys);
+  std::fill(kinds.begin(), kinds.begin() + locks, true);
+  std::vector<int64_t> order(kinds.size());
+  std::iota(order.begin(), order.end(), 0);
+  r.shuffle(order);
+
+  for (std::size_t n = 0; n < order.size(); ++n) {
+    bool const is_lock = kinds[order[n]];
+    int heights[5];
+    for (int& h : heights) { h = r.between(0, 5); }
+
+    if (n > 0) { out << '\n'; }
+    for (int row = 0; row < 7; ++row) {
+      for (int col = 0; col < 5; ++col) {
+        bool const filled = is_lock ? row <= heights[col] : row >= 6 - heights[col];
+        out << (filled ? '#' : '.');
+      }
+      out << '\n';
+    }
+  }
+}
+
+struct generator {
+  void (*fn)(options&, rng&, std::ostream&);
+  std::string_view knobs;
+};
+
+std::map<std::string_view, generator> const generators{
+  {"01", {gen_day_01, "pairs=1000"}},
+  {"02", {gen_day_02, "reports=1000 safe=0.5 damaged=0.3 min_levels=5 max_levels=8"}},
+  {"03", {gen_day_03, "bytes=18000 line_len=3000"}},
+  {"04", {gen_day_04, "rows=140 cols=140 plant=0.02"}},
+  {"05", {gen_day_05, "pages=49 updates=200 max_len=23"}},
+  {"06", {gen_day_06, "rows=130 cols=130 density=0.048"}},
+  {"07", {gen_day_07, "equations=850 max_operands=12"}},
+  {"08", {gen_day_08, "rows=50 cols=50 frequencies=44"}},
+  {"09", {gen_day_09, "length=19999"}},
+  {"10", {gen_day_10, "rows=47 cols=47 peaks=rows*cols/100+1 noise=0.1"}},
+  {"17", {gen_day_17, "bits=48"}},
+  {"19", {gen_day_19, "patterns=447 designs=400 possible=0.6"}},
+  {"20", {gen_day_20, "rows=141 cols=141"}},
+  {"23", {gen_day_23, "nodes=520 degree=13 clique=13"}},
+  {"24", {gen_day_24, "bits=45 swaps=4"}},
+  {"25", {gen_day_25, "locks=250 keys=250"}},
+};
+
+void print_usage(char const* prog) {
+  std::cerr << "usage: " << prog << " <day> [seed=N] [key=value ...] > input.txt\n\n"
+            << "days and their knobs (defaults match the real puzzle size):\n";
+  for (auto const& [day, gen] : generators) {
+    std::cerr << "  " << day << "  " << gen.knobs << '\n';
+  }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  if (argc < 2) {
+    print_usage(argv[0]);
+    return 1;
+  }
+
+  std::string day{argv[1]};
+  if (day.size() == 1) { day.insert(0, "0"); }
+  auto const it = generators.find(day);
+  if (it == generators.end()) {
+    std::cerr << "no generator for day `" << argv[1] << "`\n\n";
+    print_usage(argv[0]);
+    return 1;
+  }
+
+  std::ios::sync_with_stdio(false);
+  try {
+    options opts{argc - 2, argv + 2};
+    rng r{static_cast<u64>(opts.get_int("seed", 2024))};
+    it->second.fn(opts, r, std::cout);
+  } catch (std::exception const& e) {
+    std::cerr << "error: " << e.what() << '\n';
+    return 1;
+  }
+  std::cout.flush();
+}